@@ -0,0 +1,487 @@
+#include "batch.h"
+
+#define SOLVED_STATUS "solved"
+#define UNSOLVABLE_STATUS "unsolvable"
+#define INVALID_STATUS "invalid"
+
+/**
+ * BatchPuzzleStatus enum represents the outcome of processing one puzzle of a batch.
+ */
+typedef enum {
+	BATCH_PUZZLE_SOLVED,
+	BATCH_PUZZLE_UNSOLVABLE,
+	BATCH_PUZZLE_INVALID,
+	BATCH_PUZZLE_RATED
+} BatchPuzzleStatus;
+
+/**
+ * The longest rating written by runRateBatch, in place of a status: a tier, a technique and a
+ * search depth (see writeRatedPuzzle).
+ */
+#define RATING_LABEL_MAX_LENGTH (64)
+
+/**
+ * BatchCounters struct keeps the number of puzzles of each outcome processed by a batch run.
+ */
+typedef struct {
+	long numSolved;
+	long numUnsolvable;
+	long numInvalid;
+} BatchCounters;
+
+/**
+ * SolveBatch struct holds the state of a batch run that is shared by the callbacks of the
+ * work pool. The reader is only used by the producer and the writer and counters only by the
+ * consumer, both of which run on the calling thread.
+ */
+typedef struct {
+	PuzzleReader* reader;
+	PuzzleWriter* writer;
+	BatchCounters counters;
+} SolveBatch;
+
+/**
+ * GenerateBatch struct holds the state of a generation run that is shared by the callbacks of
+ * the work pool. The counters are only used by the producer and the consumer, which run on the
+ * calling thread; the other fields are read only.
+ */
+typedef struct {
+	PuzzleWriter* writer;
+	long numToGenerate;
+	long numProduced;
+	long numGenerated;
+	int numClues;
+	bool isUnique;
+	unsigned long seed;
+} GenerateBatch;
+
+/**
+ * RateBatch struct holds the state of a rating run that is shared by the callbacks of the work
+ * pool. As with SolveBatch, the reader is only used by the producer and the writer and
+ * counters only by the consumer, both of which run on the calling thread.
+ */
+typedef struct {
+	PuzzleReader* reader;
+	PuzzleWriter* writer;
+	long numRated[NUM_DIFFICULTY_TIERS];
+	long numUnsolvable;
+	long numInvalid;
+} RateBatch;
+
+/**
+ * printBatchSummary prints the counters of a batch run, and its throughput, to stderr.
+ *
+ * @param counters 		[in] the counters of the run
+ * @param seconds 		[in] the duration of the run, in seconds
+ */
+void printBatchSummary(BatchCounters* counters, double seconds) {
+	long numPuzzles = counters->numSolved + counters->numUnsolvable + counters->numInvalid;
+	fprintf(stderr, "Batch: %ld puzzles, %ld solved, %ld unsolvable, %ld invalid, %.3f seconds, %.0f puzzles/sec\n",
+			numPuzzles, counters->numSolved, counters->numUnsolvable, counters->numInvalid,
+			seconds, (seconds > 0) ? numPuzzles / seconds : 0.0);
+}
+
+/**
+ * produceBatchPuzzle reads the next puzzle of a batch into a work item.
+ *
+ * @param context	[in, out] the SolveBatch
+ * @param item 		[in, out] the item to be filled
+ * @return true 	iff a puzzle was read
+ * @return false 	iff the puzzle file has ended
+ */
+bool produceBatchPuzzle(void* context, WorkItem* item) {
+	SolveBatch* batch = (SolveBatch*)context;
+	PuzzleReadResult readResult = readPuzzle(batch->reader, item->board);
+
+	item->status = (readResult == PUZZLE_INVALID) ? BATCH_PUZZLE_INVALID : BATCH_PUZZLE_SOLVED;
+	return readResult != PUZZLE_END;
+}
+
+/**
+ * solveBatchPuzzle solves the puzzle of a work item in the scratch board of the calling
+ * worker, and copies the solution back if one was found.
+ *
+ * @param context	[in] the SolveBatch (unused)
+ * @param item 		[in, out] the item to be solved
+ * @param scratch 	[in, out] the scratch board of the calling worker
+ */
+void solveBatchPuzzle(void* context, WorkItem* item, Board* scratch) {
+	(void)context;
+
+	if (item->status == BATCH_PUZZLE_INVALID) {
+		return;
+	}
+
+	copyBoard(scratch, item->board);
+	if (solveBoard(scratch, NULL, NULL) == SOLVER_SOLVED) {
+		copyBoard(item->board, scratch);
+		item->status = BATCH_PUZZLE_SOLVED;
+	} else {
+		item->status = BATCH_PUZZLE_UNSOLVABLE;
+	}
+}
+
+/**
+ * writeBatchPuzzle writes the outcome of a work item to the output file, and counts it.
+ *
+ * @param context	[in, out] the SolveBatch
+ * @param item 		[in] the processed item
+ */
+void writeBatchPuzzle(void* context, WorkItem* item) {
+	SolveBatch* batch = (SolveBatch*)context;
+
+	switch (item->status) {
+	case BATCH_PUZZLE_SOLVED:
+		writePuzzle(batch->writer, SOLVED_STATUS, item->board);
+		batch->counters.numSolved++;
+		break;
+	case BATCH_PUZZLE_UNSOLVABLE:
+		writePuzzle(batch->writer, UNSOLVABLE_STATUS, item->board);
+		batch->counters.numUnsolvable++;
+		break;
+	default:
+		writePuzzle(batch->writer, INVALID_STATUS, item->board);
+		batch->counters.numInvalid++;
+		break;
+	}
+}
+
+bool isBatchSolvingSupported() {
+	SolverEngine engine = getSolverEngine();
+	return (engine == BACKTRACKING_ENGINE || engine == MRV_ENGINE) && !isConstraintPropagationEnabled();
+}
+
+bool runSolveBatch(char* inputPath, char* outputPath, int blockSize, int numThreads) {
+	SolveBatch batch = {NULL, NULL, {0, 0, 0}};
+	bool isSuccessful = false;
+	double startTime = getWallClockSeconds();
+
+	batch.reader = malloc(sizeof(PuzzleReader));
+	batch.writer = malloc(sizeof(PuzzleWriter));
+	if (batch.reader == NULL || batch.writer == NULL) {
+		/* NOTE: for now we are allowed this behaviour: */
+		printf("Error: runSolveBatch has failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (!openPuzzleReader(batch.reader, inputPath)) {
+		fprintf(stderr, "Error: could not open %s\n", inputPath);
+	} else {
+		if (!openPuzzleWriter(batch.writer, outputPath)) {
+			fprintf(stderr, "Error: could not open %s\n", outputPath);
+		} else {
+			/* a binary file records the size of its boards */
+			if (getPuzzleReaderBlockSize(batch.reader) != 0) {
+				blockSize = getPuzzleReaderBlockSize(batch.reader);
+			}
+			runWorkPool(numThreads, blockSize, produceBatchPuzzle, solveBatchPuzzle, writeBatchPuzzle, &batch);
+
+			isSuccessful = closePuzzleWriter(batch.writer);
+			if (!isSuccessful) {
+				fprintf(stderr, "Error: could not write %s\n", outputPath);
+			}
+		}
+		closePuzzleReader(batch.reader);
+	}
+
+	if (isSuccessful) {
+		printBatchSummary(&batch.counters, getWallClockSeconds() - startTime);
+	}
+
+	free(batch.reader);
+	free(batch.writer);
+	return isSuccessful;
+}
+
+/**
+ * produceGenerationJob hands out an empty board to be generated, until the requested number
+ * of puzzles is reached.
+ *
+ * @param context	[in, out] the GenerateBatch
+ * @param item 		[in, out] the item to be filled
+ * @return true 	iff a board was handed out
+ * @return false 	iff enough boards were handed out
+ */
+bool produceGenerationJob(void* context, WorkItem* item) {
+	GenerateBatch* batch = (GenerateBatch*)context;
+
+	if (batch->numProduced == batch->numToGenerate) {
+		return false;
+	}
+
+	clearBoard(item->board);
+	batch->numProduced++;
+	return true;
+}
+
+/**
+ * generateBatchPuzzle fills the board of a work item with a random solution, and fixes the
+ * cells which will be the clues of its puzzle. Every puzzle has its own random stream, drawn
+ * from the seed of the run and the number of the puzzle, so it does not depend on the thread
+ * which generates it.
+ *
+ * @param context	[in] the GenerateBatch
+ * @param item 		[in, out] the item whose board is generated
+ * @param scratch 	[in, out] the scratch board of the calling worker (unused)
+ */
+void generateBatchPuzzle(void* context, WorkItem* item, Board* scratch) {
+	GenerateBatch* batch = (GenerateBatch*)context;
+	RandomGenerator generator;
+	(void)scratch;
+
+	seedRandomGenerator(&generator, batch->seed, (unsigned long)item->sequenceNumber);
+	if (generatePuzzle(item->board, &generator, NULL, NULL) != SOLVER_SOLVED) {
+		item->status = BATCH_PUZZLE_UNSOLVABLE;
+		return;
+	}
+
+	if (batch->isUnique) {
+		fixUniqueClues(item->board, batch->numClues, &generator);
+	} else {
+		randomlyFixCells(item->board, batch->numClues, &generator);
+	}
+	item->status = BATCH_PUZZLE_SOLVED;
+}
+
+/**
+ * writeGenerationResult writes a generated puzzle and its solution to the output file.
+ *
+ * @param context	[in, out] the GenerateBatch
+ * @param item 		[in] the generated item
+ */
+void writeGenerationResult(void* context, WorkItem* item) {
+	GenerateBatch* batch = (GenerateBatch*)context;
+
+	if (item->status == BATCH_PUZZLE_SOLVED) {
+		writeGeneratedPuzzle(batch->writer, item->board);
+		batch->numGenerated++;
+	}
+}
+
+bool runGenerateBatch(char* outputPath, int blockSize, long numPuzzles, int numClues, bool isUnique,
+					  unsigned long seed, int numThreads) {
+	GenerateBatch batch = {NULL, 0, 0, 0, 0, false, 0};
+	int dimension = blockSize * blockSize;
+	bool isSuccessful = false;
+	double startTime = getWallClockSeconds(), seconds = 0;
+
+	if (numClues < 0 || numClues >= dimension * dimension) {
+		fprintf(stderr, "Error: the number of clues should be between %d and %d\n", 0, dimension * dimension - 1);
+		return false;
+	}
+
+	batch.writer = malloc(sizeof(PuzzleWriter));
+	if (batch.writer == NULL) {
+		/* NOTE: for now we are allowed this behaviour: */
+		printf("Error: runGenerateBatch has failed\n");
+		exit(EXIT_FAILURE);
+	}
+	batch.numToGenerate = numPuzzles;
+	batch.numClues = numClues;
+	batch.isUnique = isUnique;
+	batch.seed = seed;
+
+	if (!openPuzzleWriter(batch.writer, outputPath)) {
+		fprintf(stderr, "Error: could not open %s\n", outputPath);
+	} else {
+		runWorkPool(numThreads, blockSize, produceGenerationJob, generateBatchPuzzle, writeGenerationResult, &batch);
+
+		isSuccessful = closePuzzleWriter(batch.writer);
+		if (!isSuccessful) {
+			fprintf(stderr, "Error: could not write %s\n", outputPath);
+		}
+	}
+
+	if (isSuccessful) {
+		seconds = getWallClockSeconds() - startTime;
+		fprintf(stderr, "Generate: %ld puzzles, %.3f seconds, %.0f puzzles/sec\n",
+				batch.numGenerated, seconds, (seconds > 0) ? batch.numGenerated / seconds : 0.0);
+	}
+
+	free(batch.writer);
+	return isSuccessful;
+}
+
+/**
+ * produceRatePuzzle reads the next puzzle of a rating run into a work item.
+ *
+ * @param context	[in, out] the RateBatch
+ * @param item 		[in, out] the item to be filled
+ * @return true 	iff a puzzle was read
+ * @return false 	iff the puzzle file has ended
+ */
+bool produceRatePuzzle(void* context, WorkItem* item) {
+	RateBatch* batch = (RateBatch*)context;
+	PuzzleReadResult readResult = readPuzzle(batch->reader, item->board);
+
+	item->status = (readResult == PUZZLE_INVALID) ? BATCH_PUZZLE_INVALID : BATCH_PUZZLE_RATED;
+	return readResult != PUZZLE_END;
+}
+
+/**
+ * rateBatchPuzzle rates the puzzle of a work item (see ratePuzzle). The status of a rated item
+ * carries its rating: BATCH_PUZZLE_RATED, plus its hardest technique, plus its search depth
+ * times NUM_RATING_TECHNIQUES.
+ *
+ * @param context	[in] the RateBatch (unused)
+ * @param item 		[in, out] the item to be rated; its board is left unchanged
+ * @param scratch 	[in, out] the scratch board of the calling worker (unused)
+ */
+void rateBatchPuzzle(void* context, WorkItem* item, Board* scratch) {
+	PuzzleRating rating;
+	(void)context;
+	(void)scratch;
+
+	if (item->status == BATCH_PUZZLE_INVALID) {
+		return;
+	}
+
+	if (ratePuzzle(item->board, NULL, &rating) == SOLVER_SOLVED) {
+		item->status = BATCH_PUZZLE_RATED + (int)rating.hardestTechnique + NUM_RATING_TECHNIQUES * rating.searchDepth;
+	} else {
+		item->status = BATCH_PUZZLE_UNSOLVABLE;
+	}
+}
+
+/**
+ * writeRatedPuzzle writes the outcome of a rated work item to the output file, and counts it.
+ * A rated puzzle is written with its tier, its hardest technique and its search depth (0 if
+ * no search was needed) in place of a status, e.g. "hard naked-pair 0"; these are only kept
+ * in text files.
+ *
+ * @param context	[in, out] the RateBatch
+ * @param item 		[in] the processed item
+ */
+void writeRatedPuzzle(void* context, WorkItem* item) {
+	RateBatch* batch = (RateBatch*)context;
+	char label[RATING_LABEL_MAX_LENGTH];
+	PuzzleRating rating;
+	DifficultyTier tier = TIER_EASY;
+
+	switch (item->status) {
+	case BATCH_PUZZLE_UNSOLVABLE:
+		writePuzzle(batch->writer, UNSOLVABLE_STATUS, item->board);
+		batch->numUnsolvable++;
+		return;
+	case BATCH_PUZZLE_INVALID:
+		writePuzzle(batch->writer, INVALID_STATUS, item->board);
+		batch->numInvalid++;
+		return;
+	}
+
+	rating.hardestTechnique = (RatingTechnique)((item->status - BATCH_PUZZLE_RATED) % NUM_RATING_TECHNIQUES);
+	rating.searchDepth = (item->status - BATCH_PUZZLE_RATED) / NUM_RATING_TECHNIQUES;
+	tier = getDifficultyTier(&rating);
+
+	sprintf(label, "%s %s %d", getDifficultyTierName(tier), getRatingTechniqueName(rating.hardestTechnique),
+			rating.searchDepth);
+	writePuzzle(batch->writer, label, item->board);
+	batch->numRated[tier]++;
+}
+
+bool runRateBatch(char* inputPath, char* outputPath, int blockSize, int numThreads) {
+	RateBatch batch;
+	bool isSuccessful = false;
+	double startTime = getWallClockSeconds(), seconds = 0;
+	long numPuzzles = 0;
+	int tier = 0;
+
+	memset(&batch, 0, sizeof(RateBatch));
+	batch.reader = malloc(sizeof(PuzzleReader));
+	batch.writer = malloc(sizeof(PuzzleWriter));
+	if (batch.reader == NULL || batch.writer == NULL) {
+		/* NOTE: for now we are allowed this behaviour: */
+		printf("Error: runRateBatch has failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (!openPuzzleReader(batch.reader, inputPath)) {
+		fprintf(stderr, "Error: could not open %s\n", inputPath);
+	} else {
+		if (!openPuzzleWriter(batch.writer, outputPath)) {
+			fprintf(stderr, "Error: could not open %s\n", outputPath);
+		} else {
+			if (getPuzzleReaderBlockSize(batch.reader) != 0) {
+				blockSize = getPuzzleReaderBlockSize(batch.reader);
+			}
+			runWorkPool(numThreads, blockSize, produceRatePuzzle, rateBatchPuzzle, writeRatedPuzzle, &batch);
+
+			isSuccessful = closePuzzleWriter(batch.writer);
+			if (!isSuccessful) {
+				fprintf(stderr, "Error: could not write %s\n", outputPath);
+			}
+		}
+		closePuzzleReader(batch.reader);
+	}
+
+	if (isSuccessful) {
+		seconds = getWallClockSeconds() - startTime;
+		numPuzzles = batch.numUnsolvable + batch.numInvalid;
+		for (tier = 0; tier < NUM_DIFFICULTY_TIERS; tier++) {
+			numPuzzles += batch.numRated[tier];
+		}
+		fprintf(stderr, "Rate: %ld puzzles, %ld easy, %ld medium, %ld hard, %ld expert, %ld extreme, %ld unsolvable, %ld invalid, %.3f seconds, %.0f puzzles/sec\n",
+				numPuzzles, batch.numRated[TIER_EASY], batch.numRated[TIER_MEDIUM], batch.numRated[TIER_HARD],
+				batch.numRated[TIER_EXPERT], batch.numRated[TIER_EXTREME], batch.numUnsolvable, batch.numInvalid,
+				seconds, (seconds > 0) ? numPuzzles / seconds : 0.0);
+	}
+
+	free(batch.reader);
+	free(batch.writer);
+	return isSuccessful;
+}
+
+bool runConvertBatch(char* inputPath, char* outputPath, int blockSize) {
+	PuzzleReader* reader = malloc(sizeof(PuzzleReader));
+	PuzzleWriter* writer = malloc(sizeof(PuzzleWriter));
+	Board* board = NULL;
+	long numConverted = 0, numInvalid = 0;
+	bool isSuccessful = false;
+	double startTime = getWallClockSeconds(), seconds = 0;
+
+	if (reader == NULL || writer == NULL) {
+		/* NOTE: for now we are allowed this behaviour: */
+		printf("Error: runConvertBatch has failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (!openPuzzleReader(reader, inputPath)) {
+		fprintf(stderr, "Error: could not open %s\n", inputPath);
+	} else {
+		if (!openPuzzleWriter(writer, outputPath)) {
+			fprintf(stderr, "Error: could not open %s\n", outputPath);
+		} else {
+			PuzzleReadResult readResult = PUZZLE_READ;
+
+			if (getPuzzleReaderBlockSize(reader) != 0) {
+				blockSize = getPuzzleReaderBlockSize(reader);
+			}
+			board = createBoard(blockSize);
+			while ((readResult = readPuzzle(reader, board)) != PUZZLE_END) {
+				if (readResult == PUZZLE_READ) {
+					writeBoard(writer, board);
+					numConverted++;
+				} else {
+					numInvalid++;
+				}
+			}
+			destroyBoard(board);
+
+			isSuccessful = closePuzzleWriter(writer);
+			if (!isSuccessful) {
+				fprintf(stderr, "Error: could not write %s\n", outputPath);
+			}
+		}
+		closePuzzleReader(reader);
+	}
+
+	if (isSuccessful) {
+		seconds = getWallClockSeconds() - startTime;
+		fprintf(stderr, "Convert: %ld puzzles, %ld invalid skipped, %.3f seconds, %.0f puzzles/sec\n",
+				numConverted, numInvalid, seconds, (seconds > 0) ? numConverted / seconds : 0.0);
+	}
+
+	free(reader);
+	free(writer);
+	return isSuccessful;
+}
@@ -0,0 +1,115 @@
+/**
+ * BATCH Summary:
+ *
+ * A module designed to process corpora of sudoku puzzles non-interactively.
+ *
+ * isBatchSolvingSupported - checks whether the selected engine may solve puzzles in bulk
+ * runSolveBatch - solves every puzzle of a puzzle file
+ * runGenerateBatch - generates puzzles in bulk into a puzzle file
+ * runRateBatch - rates the difficulty of every puzzle of a puzzle file
+ * runConvertBatch - converts a puzzle file between the text and binary formats
+ */
+
+#ifndef BATCH_H_
+#define BATCH_H_
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "puzzle_io.h"
+#include "rating.h"
+#include "solver.h"
+#include "timing.h"
+#include "workpool.h"
+
+/**
+ * isBatchSolvingSupported checks whether the currently selected solver engine solves boards
+ * in place, without allocating, as runSolveBatch requires. DLX_ENGINE, ITERATIVE_ENGINE and
+ * PARALLEL_ENGINE allocate their search structures on every solve, and so does constraint
+ * propagation (see setConstraintPropagation).
+ *
+ * @return true 	iff the engine is BACKTRACKING_ENGINE or MRV_ENGINE, without propagation
+ * @return false 	otherwise
+ */
+bool isBatchSolvingSupported();
+
+/**
+ * runSolveBatch streams the puzzles of a puzzle file (see puzzle_io.h), solves each of them
+ * with the currently selected solver engine, and writes one line per puzzle, in input order:
+ * its status ("solved", "unsolvable" or "invalid") followed by the solution, or by the puzzle
+ * itself if it was not solved. A summary (counts and wall clock throughput) is printed to
+ * stderr. Puzzles are solved on a pool of worker threads (see workpool.h), so memory use is
+ * bounded by the number of threads rather than by the size of the file.
+ * Either file may be in the binary format (see BINARY_PUZZLE_MAGIC).
+ * Nothing is allocated per puzzle, as long as the engine solves in place: BACKTRACKING_ENGINE
+ * or MRV_ENGINE, without constraint propagation (see isBatchSolvingSupported).
+ *
+ * @param inputPath 	[in] the path of the puzzle file, or "-" for the standard input
+ * @param outputPath 	[in] the path of the output file, or "-" for the standard output
+ * @param blockSize 	[in] the block size of the puzzles in the file, if it is a text file
+ * @param numThreads 	[in] the number of worker threads; 1 solves on the calling thread
+ * @return true 		iff the whole input was processed
+ * @return false 		iff one of the files could not be opened or written
+ */
+bool runSolveBatch(char* inputPath, char* outputPath, int blockSize, int numThreads);
+
+/**
+ * runGenerateBatch generates a number of random puzzles, along with their solutions, on a pool
+ * of worker threads (see workpool.h), and writes one line per puzzle: the puzzle, a space,
+ * and its solution (see writeGeneratedPuzzle). Each puzzle is generated as by a new game:
+ * a random solution is generated (see generatePuzzle), then numClues of its cells are kept as
+ * clues. A summary (count and wall clock throughput) is printed to stderr.
+ *
+ * @param outputPath 	[in] the path of the output file, or "-" for the standard output
+ * @param blockSize 	[in] the block size of the puzzles to be generated
+ * @param numPuzzles 	[in] the number of puzzles to be generated
+ * @param numClues 		[in] the number of clues of every puzzle
+ * @param isUnique 		[in] if true, clues are chosen so that every puzzle has a unique
+ * 						solution (see fixUniqueClues), in which case some puzzles may have more
+ * 						than numClues clues; if false, they are chosen at random
+ * @param seed 			[in] the seed of the run; puzzle i is generated from stream i of
+ * 						this seed (see seedRandomGenerator), whatever the number of threads
+ * @param numThreads 	[in] the number of worker threads; 1 generates on the calling thread
+ * @return true 		iff all the puzzles were generated and written
+ * @return false 		iff numClues is out of range, or the file could not be opened or written
+ */
+bool runGenerateBatch(char* outputPath, int blockSize, long numPuzzles, int numClues, bool isUnique,
+					  unsigned long seed, int numThreads);
+
+/**
+ * runRateBatch streams the puzzles of a puzzle file, rates the difficulty of each of them (see
+ * ratePuzzle), and writes one line per puzzle, in input order: its difficulty tier, its
+ * hardest technique and its search depth (0 if it was solved without search), followed by the
+ * puzzle itself, e.g. "medium locked-candidates 0 <puzzle>". Puzzles which have no solution,
+ * or could not be read, get the status "unsolvable" or "invalid" instead. A summary (counts of
+ * each tier and wall clock throughput) is printed to stderr. Puzzles are rated on a pool of
+ * worker threads (see workpool.h).
+ * The input may be in the binary format (see BINARY_PUZZLE_MAGIC); ratings are only written
+ * to text files.
+ *
+ * @param inputPath 	[in] the path of the puzzle file, or "-" for the standard input
+ * @param outputPath 	[in] the path of the output file, or "-" for the standard output
+ * @param blockSize 	[in] the block size of the puzzles in the file, if it is a text file
+ * @param numThreads 	[in] the number of worker threads; 1 rates on the calling thread
+ * @return true 		iff the whole input was processed
+ * @return false 		iff one of the files could not be opened or written
+ */
+bool runRateBatch(char* inputPath, char* outputPath, int blockSize, int numThreads);
+
+/**
+ * runConvertBatch streams the puzzles of a puzzle file and writes each of them alone to
+ * another (see writeBoard), so that text files can be converted to the binary format (see
+ * BINARY_PUZZLE_MAGIC) and back. Invalid puzzles are skipped. A summary (counts and wall clock
+ * throughput) is printed to stderr.
+ *
+ * @param inputPath 	[in] the path of the puzzle file, or "-" for the standard input
+ * @param outputPath 	[in] the path of the output file, or "-" for the standard output; it is
+ * 						written in the binary format iff it ends with BINARY_PUZZLE_EXTENSION
+ * @param blockSize 	[in] the block size of the puzzles in the file, if it is a text file
+ * @return true 		iff the whole input was converted
+ * @return false 		iff one of the files could not be opened or written
+ */
+bool runConvertBatch(char* inputPath, char* outputPath, int blockSize);
+
+#endif /* BATCH_H_ */
@@ -0,0 +1,370 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "main_aux.h"
+#include "puzzle_io.h"
+#include "random.h"
+#include "solver.h"
+#include "timing.h"
+
+#define MICROSECONDS_PER_SECOND (1e6)
+
+/**
+ * The number of boards generated by the generation benchmark, unless --generate is given.
+ */
+#define DEFAULT_NUM_BOARDS_TO_GENERATE (1000)
+
+/**
+ * The engine column of the generation benchmark when generation does not depend on the
+ * selected engine (see getGenerationEngineName).
+ */
+#define ANY_ENGINE_NAME "any"
+
+/**
+ * BenchResult struct holds the measurements of one benchmark: the latency and the number of
+ * nodes of every call, and the wall clock duration of all of them together.
+ */
+typedef struct {
+	long numCalls;
+	long numSucceeded;
+	double seconds;
+	double* latencies;
+	long* nodeCounts;
+} BenchResult;
+
+/**
+ * createBenchResult allocates the measurements of a benchmark of a given number of calls. If
+ * allocation fails, an error message is printed out and the process is terminated.
+ *
+ * @param result		[out] the measurements to be allocated
+ * @param numCalls 		[in] the number of calls the benchmark makes
+ */
+void createBenchResult(BenchResult* result, long numCalls) {
+	result->numCalls = numCalls;
+	result->numSucceeded = 0;
+	result->seconds = 0;
+	result->latencies = calloc(numCalls + 1, sizeof(double));
+	result->nodeCounts = calloc(numCalls + 1, sizeof(long));
+	if (result->latencies == NULL || result->nodeCounts == NULL) {
+		/* NOTE: for now we are allowed this behaviour: */
+		printf("Error: createBenchResult has failed\n");
+		exit(EXIT_FAILURE);
+	}
+}
+
+/**
+ * destroyBenchResult frees the measurements of a benchmark.
+ *
+ * @param result	[in] the measurements allocated by createBenchResult
+ */
+void destroyBenchResult(BenchResult* result) {
+	free(result->latencies);
+	free(result->nodeCounts);
+}
+
+/**
+ * compareLatencies orders two latencies ascendingly, for qsort.
+ *
+ * @param first		[in] a pointer to the first latency
+ * @param second 	[in] a pointer to the second latency
+ * @return int		negative, zero or positive as first is below, equal to or above second
+ */
+int compareLatencies(const void* first, const void* second) {
+	double difference = *(const double*)first - *(const double*)second;
+	return (difference > 0) - (difference < 0);
+}
+
+/**
+ * getLatencyPercentile returns a percentile of the latencies of a benchmark, by the nearest
+ * rank method. The latencies must already be sorted.
+ *
+ * @param result		[in] the measurements, with latencies sorted ascendingly
+ * @param percentile 	[in] the percentile, between 0 and 100
+ * @return double		the latency at that percentile, in seconds
+ */
+double getLatencyPercentile(BenchResult* result, int percentile) {
+	long rank = (result->numCalls * percentile + 99) / 100;
+	if (result->numCalls == 0) {
+		return 0;
+	}
+	return result->latencies[(rank > 0) ? rank - 1 : 0];
+}
+
+/**
+ * printBenchHeader prints the header line of the report, naming its comma separated fields.
+ */
+void printBenchHeader() {
+	printf("benchmark,engine,propagate,node_budget,size,calls,succeeded,seconds,calls_per_sec,p50_us,p99_us,mean_nodes,max_nodes\n");
+}
+
+/**
+ * printBenchResult prints the line of a benchmark in the report. The latencies of the result
+ * are sorted in the process.
+ *
+ * @param name			[in] the name of the benchmark
+ * @param engineName 	[in] the name of the solver engine benchmarked
+ * @param isPropagating [in] whether constraint propagation was enabled
+ * @param budget 		[in] the budget of every call; calls which exhausted it did not succeed
+ * @param blockSize 	[in] the block size of the boards
+ * @param result 		[in, out] the measurements of the benchmark
+ */
+void printBenchResult(char* name, char* engineName, bool isPropagating, SearchBudget* budget, int blockSize, BenchResult* result) {
+	long totalNodes = 0, maxNodes = 0;
+	long i = 0;
+
+	for (i = 0; i < result->numCalls; i++) {
+		totalNodes += result->nodeCounts[i];
+		if (result->nodeCounts[i] > maxNodes) {
+			maxNodes = result->nodeCounts[i];
+		}
+	}
+	qsort(result->latencies, result->numCalls, sizeof(double), compareLatencies);
+
+	printf("%s,%s,%d,%ld,%d,%ld,%ld,%.6f,%.1f,%.2f,%.2f,%.1f,%ld\n",
+		   name, engineName, isPropagating ? 1 : 0, budget->maxNodes, blockSize * blockSize,
+		   result->numCalls, result->numSucceeded, result->seconds,
+		   (result->seconds > 0) ? result->numCalls / result->seconds : 0.0,
+		   getLatencyPercentile(result, 50) * MICROSECONDS_PER_SECOND,
+		   getLatencyPercentile(result, 99) * MICROSECONDS_PER_SECOND,
+		   (result->numCalls > 0) ? (double)totalNodes / result->numCalls : 0.0, maxNodes);
+}
+
+/**
+ * loadCorpus reads all the puzzles of a puzzle file into memory, so that reading them is not
+ * part of the measurements. Invalid puzzles are skipped. If allocation fails, an error message
+ * is printed out and the process is terminated.
+ *
+ * @param path			[in] the path of the puzzle file
+ * @param blockSize 	[in] the block size of the puzzles in the file
+ * @param puzzlesOut 	[out] assigned with the puzzles read, to be freed along with every puzzle
+ * @param numPuzzlesOut [out] assigned with the number of puzzles read
+ * @return true 		iff the puzzle file was read
+ * @return false 		iff the puzzle file could not be opened
+ */
+bool loadCorpus(char* path, int blockSize, Board*** puzzlesOut, long* numPuzzlesOut) {
+	PuzzleReader* reader = malloc(sizeof(PuzzleReader));
+	Board** puzzles = NULL;
+	long numPuzzles = 0, capacity = 0;
+	Board* board = NULL;
+	PuzzleReadResult readResult = PUZZLE_READ;
+
+	if (reader == NULL) {
+		/* NOTE: for now we are allowed this behaviour: */
+		printf("Error: loadCorpus has failed\n");
+		exit(EXIT_FAILURE);
+	}
+	if (!openPuzzleReader(reader, path)) {
+		free(reader);
+		return false;
+	}
+
+	board = createBoard(blockSize);
+	while ((readResult = readPuzzle(reader, board)) != PUZZLE_END) {
+		if (readResult == PUZZLE_INVALID) {
+			continue;
+		}
+		if (numPuzzles == capacity) {
+			Board** grown = NULL;
+			capacity = (capacity == 0) ? 64 : capacity * 2;
+			grown = realloc(puzzles, capacity * sizeof(Board*));
+			if (grown == NULL) {
+				/* NOTE: for now we are allowed this behaviour: */
+				printf("Error: loadCorpus has failed\n");
+				exit(EXIT_FAILURE);
+			}
+			puzzles = grown;
+		}
+		puzzles[numPuzzles] = createBoard(blockSize);
+		copyBoard(puzzles[numPuzzles], board);
+		numPuzzles++;
+	}
+
+	destroyBoard(board);
+	closePuzzleReader(reader);
+	free(reader);
+	*puzzlesOut = puzzles;
+	*numPuzzlesOut = numPuzzles;
+	return true;
+}
+
+/**
+ * benchmarkSolving solves every puzzle of a corpus with the currently selected engine,
+ * measuring each call of solveBoard.
+ *
+ * @param puzzles		[in] the puzzles of the corpus
+ * @param numPuzzles 	[in] the number of puzzles
+ * @param blockSize 	[in] the block size of the puzzles
+ * @param budget 		[in] the budget of every call
+ * @param resultOut 	[out] the measurements, to be freed with destroyBenchResult
+ */
+void benchmarkSolving(Board** puzzles, long numPuzzles, int blockSize, SearchBudget* budget, BenchResult* resultOut) {
+	Board* board = createBoard(blockSize);
+	double startTime = 0;
+	long i = 0;
+
+	createBenchResult(resultOut, numPuzzles);
+	startTime = getWallClockSeconds();
+	for (i = 0; i < numPuzzles; i++) {
+		SolverStats stats;
+		double callStartTime = 0;
+
+		copyBoard(board, puzzles[i]);
+		callStartTime = getWallClockSeconds();
+		if (solveBoard(board, budget, &stats) == SOLVER_SOLVED) {
+			resultOut->numSucceeded++;
+		}
+		resultOut->latencies[i] = getWallClockSeconds() - callStartTime;
+		resultOut->nodeCounts[i] = stats.numNodes;
+	}
+	resultOut->seconds = getWallClockSeconds() - startTime;
+
+	destroyBoard(board);
+}
+
+/**
+ * benchmarkGeneration generates a number of completely filled boards, measuring each call of
+ * generatePuzzle. Board i is generated from stream i of the seed, so runs are reproducible.
+ *
+ * @param numBoards 	[in] the number of boards to generate
+ * @param blockSize 	[in] the block size of the boards
+ * @param seed 			[in] the seed of the random generators
+ * @param budget 		[in] the budget of every call
+ * @param resultOut 	[out] the measurements, to be freed with destroyBenchResult
+ */
+void benchmarkGeneration(long numBoards, int blockSize, unsigned long seed, SearchBudget* budget, BenchResult* resultOut) {
+	Board* board = createBoard(blockSize);
+	double startTime = 0;
+	long i = 0;
+
+	createBenchResult(resultOut, numBoards);
+	startTime = getWallClockSeconds();
+	for (i = 0; i < numBoards; i++) {
+		RandomGenerator generator;
+		SolverStats stats;
+		double callStartTime = 0;
+
+		clearBoard(board);
+		seedRandomGenerator(&generator, seed, (unsigned long)i);
+		callStartTime = getWallClockSeconds();
+		if (generatePuzzle(board, &generator, budget, &stats) == SOLVER_SOLVED) {
+			resultOut->numSucceeded++;
+		}
+		resultOut->latencies[i] = getWallClockSeconds() - callStartTime;
+		resultOut->nodeCounts[i] = stats.numNodes;
+	}
+	resultOut->seconds = getWallClockSeconds() - startTime;
+
+	destroyBoard(board);
+}
+
+/**
+ * getGenerationEngineName returns the name to report for the engine of the generation
+ * benchmark. generatePuzzle only follows the selected engine for ITERATIVE_ENGINE, without
+ * constraint propagation; otherwise every engine generates the same boards the same way.
+ *
+ * @param engine 		[in] the selected engine
+ * @param engineName 	[in] its name
+ * @param isPropagating [in] whether constraint propagation is enabled
+ * @return char*		engineName, or ANY_ENGINE_NAME if generation does not depend on it
+ */
+char* getGenerationEngineName(SolverEngine engine, char* engineName, bool isPropagating) {
+	return (engine == ITERATIVE_ENGINE && !isPropagating) ? engineName : ANY_ENGINE_NAME;
+}
+
+/**
+ * getCorpusName returns the name of a corpus: the file name of its path, without directories.
+ *
+ * @param path		[in] the path of the puzzle file
+ * @return char*	a pointer into path, at the start of its file name
+ */
+char* getCorpusName(char* path) {
+	char* separator = strrchr(path, '/');
+	return (separator != NULL) ? separator + 1 : path;
+}
+
+int main(int argc, char** argv) {
+	char* engineName = "backtracking";
+	SolverEngine engine = BACKTRACKING_ENGINE;
+	bool isPropagating = false;
+	int blockSize = DEFAULT_BLOCK_SIZE;
+	long numBoardsToGenerate = DEFAULT_NUM_BOARDS_TO_GENERATE;
+	unsigned long seed = 0;
+	SearchBudget budget = {0, 0};
+	bool isSuccessful = true;
+	BenchResult result;
+	int i = 0;
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--engine") == 0) {
+			if ((i + 1 == argc) || !parseSolverEngine(argv[i + 1], &engine)) {
+				printf("Error: --engine expects one of: backtracking, mrv, dlx, iterative, parallel\n");
+				return EXIT_FAILURE;
+			}
+			engineName = argv[++i];
+		} else if (strcmp(argv[i], "--size") == 0) {
+			if ((i + 1 == argc) || atoi(argv[i + 1]) < MIN_BLOCK_SIZE || atoi(argv[i + 1]) > MAX_BLOCK_SIZE) {
+				printf("Error: --size expects a block size between %d and %d\n", MIN_BLOCK_SIZE, MAX_BLOCK_SIZE);
+				return EXIT_FAILURE;
+			}
+			blockSize = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--generate") == 0) {
+			if ((i + 1 == argc) || atol(argv[i + 1]) < 0) {
+				printf("Error: --generate expects a non-negative number of boards\n");
+				return EXIT_FAILURE;
+			}
+			numBoardsToGenerate = atol(argv[++i]);
+		} else if (strcmp(argv[i], "--seed") == 0) {
+			if (i + 1 == argc) {
+				printf("Error: --seed expects a number\n");
+				return EXIT_FAILURE;
+			}
+			seed = (unsigned long)atol(argv[++i]);
+		} else if (strcmp(argv[i], "--max-nodes") == 0) {
+			if ((i + 1 == argc) || atol(argv[i + 1]) < 0) {
+				printf("Error: --max-nodes expects a non-negative number of nodes (0 for no limit)\n");
+				return EXIT_FAILURE;
+			}
+			budget.maxNodes = atol(argv[++i]);
+		} else if (strcmp(argv[i], "--propagate") == 0) {
+			isPropagating = true;
+		} else {
+			break;
+		}
+	}
+
+	setSolverEngine(engine);
+	setParallelSearch(getNumProcessors(), true);
+	setConstraintPropagation(isPropagating);
+	printBenchHeader();
+
+	/* the remaining arguments are the corpora */
+	for (; i < argc; i++) {
+		Board** puzzles = NULL;
+		long numPuzzles = 0, j = 0;
+
+		if (!loadCorpus(argv[i], blockSize, &puzzles, &numPuzzles)) {
+			fprintf(stderr, "Error: could not open %s\n", argv[i]);
+			isSuccessful = false;
+			continue;
+		}
+
+		benchmarkSolving(puzzles, numPuzzles, blockSize, &budget, &result);
+		printBenchResult(getCorpusName(argv[i]), engineName, isPropagating, &budget, blockSize, &result);
+		destroyBenchResult(&result);
+
+		for (j = 0; j < numPuzzles; j++) {
+			destroyBoard(puzzles[j]);
+		}
+		free(puzzles);
+	}
+
+	if (numBoardsToGenerate > 0) {
+		benchmarkGeneration(numBoardsToGenerate, blockSize, seed, &budget, &result);
+		printBenchResult("generate", getGenerationEngineName(engine, engineName, isPropagating), isPropagating,
+						 &budget, blockSize, &result);
+		destroyBenchResult(&result);
+	}
+
+	return isSuccessful ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,333 @@
+#include "dlx.h"
+
+/**
+ * The number of kinds of constraints of a sudoku board, each of which contributes n*n * n*n
+ * columns to the exact cover matrix: cell, row-value, column-value and block-value.
+ */
+#define NUM_CONSTRAINT_KINDS (4)
+
+/**
+ * The index of the root header node, through which all column headers are linked.
+ */
+#define ROOT_NODE (0)
+
+#define NO_COLUMN (-1)
+
+/**
+ * DancingLinks struct holds a sparse exact cover matrix as toroidal doubly linked lists. All
+ * nodes (root, column headers and matrix entries) are identified by their index in the arrays,
+ * which are all carved out of a single allocation (memory).
+ * For column headers, size holds the number of entries currently in the column. For matrix
+ * entries, placement holds the placement the entry's row stands for, encoded as
+ * ((row * dimension + col) * dimension + value - 1).
+ * columnOf maps every constraint to the node index of its column header, or NO_COLUMN if the
+ * constraint is already satisfied by the board.
+ * stats holds the counters the search adds its work to.
+ */
+typedef struct {
+	int blockSize;
+	int dimension;
+	int* columnOf;
+	int* left;
+	int* right;
+	int* up;
+	int* down;
+	int* column;
+	int* placement;
+	int* size;
+	int* solution;
+	int numNodes;
+	int solutionLength;
+	int* memory;
+	SolverStats* stats;
+} DancingLinks;
+
+/**
+ * getConstraints computes the indices of the four constraints satisfied by placing a value
+ * in a cell.
+ *
+ * @param dlx 				[in] the matrix, which determines the board dimension
+ * @param row				[in] row number of the cell
+ * @param col 				[in] column number of the cell
+ * @param value 			[in] the value placed in the cell
+ * @param constraintsOut 	[out] an array of NUM_CONSTRAINT_KINDS integers, to be assigned with
+ * 							the indices of the constraints
+ */
+void getConstraints(DancingLinks* dlx, int row, int col, int value, int* constraintsOut) {
+	int dimension = dlx->dimension, blockSize = dlx->blockSize;
+	int cellsCount = dimension * dimension;
+	int block = ((row / blockSize) * blockSize) + (col / blockSize);
+	constraintsOut[0] = row * dimension + col;
+	constraintsOut[1] = cellsCount + row * dimension + (value - 1);
+	constraintsOut[2] = 2 * cellsCount + col * dimension + (value - 1);
+	constraintsOut[3] = 3 * cellsCount + block * dimension + (value - 1);
+}
+
+/**
+ * createDancingLinks allocates the arrays of a DancingLinks struct, large enough to hold
+ * maxNodes nodes of a board of the given block size. If allocation fails, an error message is
+ * printed out and the process is terminated.
+ *
+ * @param dlx 			[in, out] the struct whose arrays are allocated
+ * @param blockSize 	[in] the block size of the board translated to the matrix
+ * @param maxNodes 		[in] the maximal number of nodes the matrix would hold
+ */
+void createDancingLinks(DancingLinks* dlx, int blockSize, int maxNodes) {
+	int numArrays = 7;
+	int dimension = blockSize * blockSize;
+	int numConstraints = NUM_CONSTRAINT_KINDS * dimension * dimension;
+	dlx->memory = calloc(numArrays * maxNodes + dimension * dimension + numConstraints, sizeof(int));
+	if (dlx->memory == NULL) {
+		/* NOTE: for now we are allowed this behaviour: */
+		printf("Error: createDancingLinks has failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	dlx->blockSize = blockSize;
+	dlx->dimension = dimension;
+	dlx->columnOf = dlx->memory;
+	dlx->left = dlx->columnOf + numConstraints;
+	dlx->right = dlx->left + maxNodes;
+	dlx->up = dlx->right + maxNodes;
+	dlx->down = dlx->up + maxNodes;
+	dlx->column = dlx->down + maxNodes;
+	dlx->placement = dlx->column + maxNodes;
+	dlx->size = dlx->placement + maxNodes;
+	dlx->solution = dlx->size + maxNodes;
+
+	dlx->left[ROOT_NODE] = ROOT_NODE;
+	dlx->right[ROOT_NODE] = ROOT_NODE;
+	dlx->numNodes = 1;
+	dlx->solutionLength = 0;
+}
+
+/**
+ * destroyDancingLinks frees the memory previously allocated by createDancingLinks.
+ *
+ * @param dlx 	[in] the struct whose arrays are freed
+ */
+void destroyDancingLinks(DancingLinks* dlx) {
+	free(dlx->memory);
+}
+
+/**
+ * addColumn appends a new, empty column header to the matrix.
+ *
+ * @param dlx 	[in, out] the matrix
+ * @return int	the node index of the new column header
+ */
+int addColumn(DancingLinks* dlx) {
+	int header = dlx->numNodes++;
+
+	dlx->left[header] = dlx->left[ROOT_NODE];
+	dlx->right[header] = ROOT_NODE;
+	dlx->right[dlx->left[ROOT_NODE]] = header;
+	dlx->left[ROOT_NODE] = header;
+
+	dlx->up[header] = header;
+	dlx->down[header] = header;
+	dlx->column[header] = header;
+	dlx->size[header] = 0;
+	return header;
+}
+
+/**
+ * addRow appends a new matrix row, with one entry in each of the provided columns.
+ *
+ * @param dlx 			[in, out] the matrix
+ * @param columns 		[in] the node indices of the column headers of the row's entries
+ * @param numColumns 	[in] the number of entries in the row
+ * @param placement 	[in] the encoded placement the row stands for
+ */
+void addRow(DancingLinks* dlx, int* columns, int numColumns, int placement) {
+	int first = dlx->numNodes;
+	int i = 0;
+
+	for (i = 0; i < numColumns; i++) {
+		int node = dlx->numNodes++;
+		int header = columns[i];
+
+		dlx->left[node] = (i == 0) ? first + numColumns - 1 : node - 1;
+		dlx->right[node] = (i == numColumns - 1) ? first : node + 1;
+
+		dlx->up[node] = dlx->up[header];
+		dlx->down[node] = header;
+		dlx->down[dlx->up[header]] = node;
+		dlx->up[header] = node;
+
+		dlx->column[node] = header;
+		dlx->placement[node] = placement;
+		dlx->size[header]++;
+	}
+}
+
+/**
+ * coverColumn removes a column from the header list, and all the rows having an entry in it
+ * from the other columns they appear in.
+ *
+ * @param dlx 		[in, out] the matrix
+ * @param header 	[in] the node index of the column header
+ */
+void coverColumn(DancingLinks* dlx, int header) {
+	int row = 0, node = 0;
+
+	dlx->right[dlx->left[header]] = dlx->right[header];
+	dlx->left[dlx->right[header]] = dlx->left[header];
+
+	for (row = dlx->down[header]; row != header; row = dlx->down[row]) {
+		for (node = dlx->right[row]; node != row; node = dlx->right[node]) {
+			dlx->down[dlx->up[node]] = dlx->down[node];
+			dlx->up[dlx->down[node]] = dlx->up[node];
+			dlx->size[dlx->column[node]]--;
+		}
+	}
+}
+
+/**
+ * uncoverColumn reverts a previous call to coverColumn with the same column. Calls must be
+ * made in the reverse order of the matching coverColumn calls.
+ *
+ * @param dlx 		[in, out] the matrix
+ * @param header 	[in] the node index of the column header
+ */
+void uncoverColumn(DancingLinks* dlx, int header) {
+	int row = 0, node = 0;
+
+	for (row = dlx->up[header]; row != header; row = dlx->up[row]) {
+		for (node = dlx->left[row]; node != row; node = dlx->left[node]) {
+			dlx->size[dlx->column[node]]++;
+			dlx->down[dlx->up[node]] = node;
+			dlx->up[dlx->down[node]] = node;
+		}
+	}
+
+	dlx->right[dlx->left[header]] = header;
+	dlx->left[dlx->right[header]] = header;
+}
+
+/**
+ * searchDLX is a recursive function implementing Algorithm X. In each call it selects the
+ * uncovered column with the fewest entries, and tries each of the rows covering it in turn.
+ *
+ * @param dlx 		[in, out] the matrix
+ * @param depth 	[in] the number of rows already selected for the solution
+ * @return true 	iff an exact cover was found; its rows are then kept in dlx->solution
+ * @return false 	iff there is no exact cover of the remaining columns
+ */
+bool searchDLX(DancingLinks* dlx, int depth) {
+	int header = 0, bestHeader = 0, row = 0, node = 0;
+
+	if (dlx->right[ROOT_NODE] == ROOT_NODE) {
+		dlx->solutionLength = depth;
+		return true;
+	}
+
+	bestHeader = dlx->right[ROOT_NODE];
+	for (header = dlx->right[bestHeader]; header != ROOT_NODE; header = dlx->right[header]) {
+		dlx->stats->numValidityChecks++;
+		if (dlx->size[header] < dlx->size[bestHeader])
+			bestHeader = header;
+	}
+
+	if (dlx->size[bestHeader] == 0) {
+		dlx->stats->numBacktracks++;
+		return false;
+	}
+
+	coverColumn(dlx, bestHeader);
+	for (row = dlx->down[bestHeader]; row != bestHeader && recordSearchNode(dlx->stats, depth + 1); row = dlx->down[row]) {
+		dlx->solution[depth] = row;
+		for (node = dlx->right[row]; node != row; node = dlx->right[node])
+			coverColumn(dlx, dlx->column[node]);
+
+		if (searchDLX(dlx, depth + 1))
+			return true;
+
+		for (node = dlx->left[row]; node != row; node = dlx->left[node])
+			uncoverColumn(dlx, dlx->column[node]);
+	}
+	uncoverColumn(dlx, bestHeader);
+
+	if (!dlx->stats->hasGivenUp) {
+		dlx->stats->numBacktracks++;
+	}
+	return false;
+}
+
+/**
+ * buildDancingLinks translates the empty cells of a sudoku board to an exact cover matrix.
+ * Constraints already satisfied by the filled cells are left out, and so are placements
+ * conflicting with them.
+ *
+ * @param dlx		[in, out] a DancingLinks struct to be allocated and filled
+ * @param board 	[in] the board to be translated
+ */
+void buildDancingLinks(DancingLinks* dlx, Board* board) {
+	int dimension = getBoardDimension(board);
+	int numConstraints = NUM_CONSTRAINT_KINDS * dimension * dimension;
+	int constraints[NUM_CONSTRAINT_KINDS] = {0};
+	int columns[NUM_CONSTRAINT_KINDS] = {0};
+	int numRows = 0;
+	int row = 0, col = 0, value = 0, i = 0;
+
+	for (row = 0; row < dimension; row++)
+		for (col = 0; col < dimension; col++)
+			if (isCellEmpty(board, row, col))
+				numRows += countMaskValues(getCellCandidates(board, row, col));
+
+	createDancingLinks(dlx, getBlockSize(board), 1 + numConstraints + NUM_CONSTRAINT_KINDS * numRows);
+
+	for (row = 0; row < dimension; row++) {
+		for (col = 0; col < dimension; col++) {
+			if (! isCellEmpty(board, row, col)) {
+				getConstraints(dlx, row, col, getCellValue(board, row, col), constraints);
+				for (i = 0; i < NUM_CONSTRAINT_KINDS; i++)
+					dlx->columnOf[constraints[i]] = NO_COLUMN;
+			}
+		}
+	}
+
+	for (i = 0; i < numConstraints; i++)
+		if (dlx->columnOf[i] != NO_COLUMN)
+			dlx->columnOf[i] = addColumn(dlx);
+
+	for (row = 0; row < dimension; row++) {
+		for (col = 0; col < dimension; col++) {
+			unsigned int candidates = 0;
+			if (! isCellEmpty(board, row, col))
+				continue;
+
+			candidates = getCellCandidates(board, row, col);
+			for (value = 1; value <= dimension; value++) {
+				if (candidates & (1u << (value - 1))) {
+					getConstraints(dlx, row, col, value, constraints);
+					for (i = 0; i < NUM_CONSTRAINT_KINDS; i++)
+						columns[i] = dlx->columnOf[constraints[i]];
+					addRow(dlx, columns, NUM_CONSTRAINT_KINDS, (row * dimension + col) * dimension + (value - 1));
+				}
+			}
+		}
+	}
+}
+
+bool solveBoardDLX(Board* board, SolverStats* statsInOut) {
+	int dimension = getBoardDimension(board);
+	DancingLinks dlx;
+	bool isSolved = false;
+	int i = 0;
+
+	buildDancingLinks(&dlx, board);
+	dlx.stats = statsInOut;
+
+	isSolved = searchDLX(&dlx, 0);
+	if (isSolved) {
+		for (i = 0; i < dlx.solutionLength; i++) {
+			int placement = dlx.placement[dlx.solution[i]];
+			int cell = placement / dimension;
+			setCellValue(board, cell / dimension, cell % dimension, (placement % dimension) + 1);
+		}
+	}
+
+	destroyDancingLinks(&dlx);
+	return isSolved;
+}
@@ -0,0 +1,37 @@
+/**
+ * DLX Summary:
+ *
+ * A module designed to solve sudoku puzzles as an exact cover problem, using Knuth's
+ * Algorithm X implemented with Dancing Links.
+ *
+ * Every sudoku board of dimension n*n is translated to 4 * (n*n)^2 constraint columns (each
+ * cell holds a value, and each row, column and block holds each value once), and one matrix
+ * row per possible placement of a value in a cell.
+ *
+ * solveBoardDLX - solves a sudoku board in place
+ */
+
+#ifndef DLX_H_
+#define DLX_H_
+
+#include "game.h"
+#include "stats.h"
+
+/**
+ * solveBoardDLX is used to solve a given sudoku board by reducing it to an exact cover
+ * problem and solving that with Dancing Links. Only placements which agree with the cells
+ * already filled in the board take part in the matrix.
+ * If the required memory could not be allocated, an error message is printed out and the
+ * process is terminated.
+ *
+ * @param board		[in, out] a pointer to the Board struct to be solved. If solving succeeds,
+ * 					its empty cells are filled with a solution; otherwise it is left unchanged
+ * @param statsInOut 	[in, out] the counters the work of the search is added to. Their budget
+ * 						applies to the search
+ * @return true 	iff the board was successfully solved
+ * @return false 	iff the board has no solution, or the budget was exhausted first (see
+ * 					hasGivenUp)
+ */
+bool solveBoardDLX(Board* board, SolverStats* statsInOut);
+
+#endif /* DLX_H_ */
@@ -1,19 +1,140 @@
 #include "game.h"
 
+/**
+ * Move struct records a single change the user made to a cell of the board: the index of the
+ * cell (in row-major order), and its values before and after the change. It takes 4 bytes,
+ * so the moves of a game may be kept without copying its board.
+ */
+typedef struct {
+	unsigned short cellIndex;
+	unsigned char oldValue;
+	unsigned char newValue;
+} Move;
+
+/**
+ * The number of moves the move log of a game initially has room for. The log doubles its
+ * capacity whenever it is full.
+ */
+#define INITIAL_MOVE_LOG_CAPACITY (64)
+
 /**
  * State struct represents a sudoku game in its current state. It contains the board itself, a 
  * possible solution for it, and the number of cells left to fill in the board in its current
  * configuration.
+ * It also keeps the log of the moves made in the game: the first numMovesDone of its numMoves
+ * moves are done, and the rest were undone and may be redone.
  * Note: the implementation of this struct is meant to be hidden from the user.
  */
 struct State {
-	Board puzzle;
-	Board solution;
+	Board* puzzle;
+	Board* solution;
 	int numNonSet;
+	int numDeviatingCells;
+	Move* moves;
+	int numMoves;
+	int numMovesDone;
+	int movesCapacity;
 };
 
+Board* createBoard(int blockSize) {
+	int dimension = blockSize * blockSize;
+	int numCells = dimension * dimension;
+	Board* board = NULL;
+	int row = 0, col = 0;
+
+	/* the masks are placed right after the struct, followed by the cells and their blocks */
+	board = calloc(1, sizeof(Board) + 3 * dimension * sizeof(unsigned int) +
+					  numCells * (sizeof(Cell) + sizeof(unsigned char)));
+	if (board == NULL) {
+		/* NOTE: for now we are allowed this behaviour: */
+		printf("Error: createBoard has failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	board->blockSize = blockSize;
+	board->dimension = dimension;
+	board->rowMasks = (unsigned int*)(board + 1);
+	board->colMasks = board->rowMasks + dimension;
+	board->blockMasks = board->colMasks + dimension;
+	board->cells = (Cell*)(board->blockMasks + dimension);
+	board->cellBlocks = (unsigned char*)(board->cells + numCells);
+
+	for (row = 0; row < dimension; row++)
+		for (col = 0; col < dimension; col++)
+			board->cellBlocks[row * dimension + col] = ((row / blockSize) * blockSize) + (col / blockSize);
+
+	return board;
+}
+
+void destroyBoard(Board* board) {
+	if (board != NULL) {
+		free(board);
+	}
+}
+
+void copyBoard(Board* dest, const Board* src) {
+	int dimension = src->dimension;
+	memcpy(dest->rowMasks, src->rowMasks, 3 * dimension * sizeof(unsigned int));
+	memcpy(dest->cells, src->cells, dimension * dimension * sizeof(Cell));
+}
+
+void clearBoard(Board* board) {
+	int dimension = board->dimension;
+	memset(board->rowMasks, 0, 3 * dimension * sizeof(unsigned int));
+	memset(board->cells, 0, dimension * dimension * sizeof(Cell));
+}
+
+int getBlockSize(const Board* board) {
+	return board->blockSize;
+}
+
+int getBoardDimension(const Board* board) {
+	return board->dimension;
+}
+
 void exportBoard(State* state, Board* boardOut) {
-	*boardOut = state->puzzle;
+	copyBoard(boardOut, state->puzzle);
+}
+
+const Board* viewPuzzle(State* state) {
+	return state->puzzle;
+}
+
+const Board* viewSolution(State* state) {
+	return state->solution;
+}
+
+int getGameBlockSize(State* state) {
+	return getBlockSize(state->puzzle);
+}
+
+/**
+ * whichBlock finds which block in the board a cell with given indices belongs to. The board
+ * blocks are of size n*n and there are n*n of them in total, numbered [0 - n*n-1], from left
+ * to right and top to bottom. The mapping is precomputed by createBoard.
+ * 
+ * @param board		[in] pointer to the Board struct the cell is in
+ * @param row		[in] the number of row the cell is in
+ * @param col 		[in] the number of column the cell is in
+ * @return int		the number of block the cell is in 
+ */
+int whichBlock(const Board* board, int row, int col) {
+	return board->cellBlocks[row * board->dimension + col];
+}
+
+/**
+ * valueMask returns the bit representing a particular value in the occupancy bitmasks
+ * of a board.
+ * 
+ * @param board		[in] pointer to the Board struct whose masks are concerned
+ * @param value		[in] the value whose bit is requested
+ * @return unsigned int		the bit matching value, or 0 if value is not within the range [1, n*n]
+ */
+unsigned int valueMask(const Board* board, int value) {
+	if (value < 1 || value > board->dimension) {
+		return 0;
+	}
+	return 1u << (value - 1);
 }
 
 /**
@@ -26,12 +147,8 @@ void exportBoard(State* state, Board* boardOut) {
  * @return true 	iff row contains value
  * @return false 	iff row does not contain value
  */
-bool rowContains(Board* board, int row, int value) {
-	int col = 0;
-	for (col = 0; col < N_SQUARE; col++)
-		if (getCellValue(board, row, col) == value)
-			return true;
-	return false;
+bool rowContains(const Board* board, int row, int value) {
+	return (board->rowMasks[row] & valueMask(board, value)) != 0;
 }
 
 /**
@@ -44,25 +161,8 @@ bool rowContains(Board* board, int row, int value) {
  * @return true 	iff column contains value
  * @return false 	iff column does not contain value
  */
-bool colContains(Board* board, int col, int value) {
-	int row = 0;
-	for (row = 0; row < N_SQUARE; row++)
-		if (getCellValue(board, row, col) == value)
-			return true;
-	return false;
-}
-
-/**
- * whichBlock uses a linear mapping to find which block in the board a cell with given
- * indices belongs to. The board blocks are of size N*N and there are N of them in total,
- * numbered [0 - N-1], from left to right and top to bottom.
- * 
- * @param row		[in] the number of row the cell is in
- * @param col 		[in] the number of column the cell is in
- * @return int		the number of block the cell is in 
- */
-int whichBlock(int row, int col) {
-	return ((row / N) * N) + (col / N);
+bool colContains(const Board* board, int col, int value) {
+	return (board->colMasks[col] & valueMask(board, value)) != 0;
 }
 
 /**
@@ -75,49 +175,69 @@ int whichBlock(int row, int col) {
  * @return true 	iff block contains value
  * @return false 	iff block does not contain value
  */
-bool blockContains(Board* board, int block, int value) {
-	int rowOffset = (block / N) * N;
-	int colOffset = (block % N) * N;
+bool blockContains(const Board* board, int block, int value) {
+	return (board->blockMasks[block] & valueMask(board, value)) != 0;
+}
 
-	int row = 0, col = 0;
-	for (row = 0; row < N; row++)
-		for (col = 0; col < N; col++)
-			if (getCellValue(board, rowOffset + row, colOffset + col) == value)
-				return true;
-	return false;
+int getCellValue(const Board* board, int row, int col) {
+	return board->cells[row * board->dimension + col] & CELL_VALUE_MASK;
 }
 
-int getCellValue(Board* board, int row, int col) {
-	return board->cells[row][col].value;
+bool isCellValueValid(const Board* board, int row, int col, int value) {
+	unsigned int usedMask = board->rowMasks[row] |
+							board->colMasks[col] |
+							board->blockMasks[whichBlock(board, row, col)];
+	return (getCellValue(board, row, col) == value) || ((usedMask & valueMask(board, value)) == 0);
 }
 
-bool isCellValueValid(Board* board, int row, int col, int value) {
-	return (getCellValue(board, row, col) == value) ||
-		   (!rowContains(board, row, value) &&
-		    !colContains(board, col, value) &&
-		    !blockContains(board, whichBlock(row, col), value));
+unsigned int getCellCandidates(const Board* board, int row, int col) {
+	unsigned int usedMask = board->rowMasks[row] |
+							board->colMasks[col] |
+							board->blockMasks[whichBlock(board, row, col)];
+	unsigned int allValuesMask = (1u << board->dimension) - 1;
+	return allValuesMask & ~usedMask;
+}
+
+int countMaskValues(unsigned int mask) {
+	int count = 0;
+	while (mask != 0) {
+		mask &= mask - 1;
+		count++;
+	}
+	return count;
+}
+
+int getMaskValue(unsigned int mask) {
+	int value = 1;
+	while ((mask & 1u) == 0) {
+		mask >>= 1;
+		value++;
+	}
+	return value;
 }
 
 void setCellValue(Board* board, int row, int col, int value) {
-	board->cells[row][col].value = value;
+	int block = whichBlock(board, row, col);
+	unsigned int oldMask = valueMask(board, getCellValue(board, row, col));
+	unsigned int newMask = valueMask(board, value);
+
+	board->rowMasks[row] = (board->rowMasks[row] & ~oldMask) | newMask;
+	board->colMasks[col] = (board->colMasks[col] & ~oldMask) | newMask;
+	board->blockMasks[block] = (board->blockMasks[block] & ~oldMask) | newMask;
+
+	board->cells[row * board->dimension + col] =
+		(Cell)((board->cells[row * board->dimension + col] & CELL_FIXED_FLAG) | value);
 }
 
-/**
- * fixCell is used during the generation of a new sudoku board to make a cell fixed.
- * 
- * @param board		[in] pointer to the Board struct whose cell is set to be fixed  
- * @param row 		[in] the row number of that cell
- * @param col 		[in] the column number of that cell
- */
 void fixCell(Board* board, int row, int col) {
-	board->cells[row][col].isFixed = true;
+	board->cells[row * board->dimension + col] |= CELL_FIXED_FLAG;
 }
 
-bool isCellFixed(Board* board, int row, int col) {
-	return board->cells[row][col].isFixed;
+bool isCellFixed(const Board* board, int row, int col) {
+	return (board->cells[row * board->dimension + col] & CELL_FIXED_FLAG) != 0;
 }
 
-bool isCellEmpty(Board* board, int row, int col) {
+bool isCellEmpty(const Board* board, int row, int col) {
 	return getCellValue(board, row, col) == EMPTY_CELL_VALUE;
 }
 
@@ -135,10 +255,15 @@ void emptyCell(Board* board, int row, int col) {
  * @param value 	[in] the value to be set to that cell
  */
 void setPuzzleCell(State* state, int row, int col, int value) {
-	if (isCellEmpty(&(state->puzzle), row, col)) {
+	if (isCellEmpty(state->puzzle, row, col)) {
 		state->numNonSet--;
+	} else if (getCellValue(state->puzzle, row, col) != getCellValue(state->solution, row, col)) {
+		state->numDeviatingCells--;
 	}
-	setCellValue(&(state->puzzle), row, col, value);
+	if (value != getCellValue(state->solution, row, col)) {
+		state->numDeviatingCells++;
+	}
+	setCellValue(state->puzzle, row, col, value);
 }
 
 /**
@@ -150,53 +275,128 @@ void setPuzzleCell(State* state, int row, int col, int value) {
  * @param col 		[in] the column number of that cell
  */
 void emptyPuzzleCell(State* state, int row, int col) {
-	if (!isCellEmpty(&(state->puzzle), row, col)) {
+	if (!isCellEmpty(state->puzzle, row, col)) {
 		state->numNonSet++;
+		if (getCellValue(state->puzzle, row, col) != getCellValue(state->solution, row, col)) {
+			state->numDeviatingCells--;
+		}
+	}
+	emptyCell(state->puzzle, row, col);
+}
+
+/**
+ * changePuzzleCell sets or empties a cell in the sudoku board, in the current state of the game
+ * (see setPuzzleCell and emptyPuzzleCell), without logging the change.
+ *
+ * @param state 	[in, out] pointer to the State struct whose cell is changed
+ * @param row 		[in] the row number of that cell
+ * @param col 		[in] the column number of that cell
+ * @param value 	[in] the value to be set to that cell, or EMPTY_CELL_VALUE to empty it
+ */
+void changePuzzleCell(State* state, int row, int col, int value) {
+	if (value != EMPTY_CELL_VALUE) {
+		setPuzzleCell(state, row, col, value);
+	} else {
+		emptyPuzzleCell(state, row, col);
 	}
-	emptyCell(&(state->puzzle), row, col);
+}
+
+/**
+ * appendMove appends a move to the move log of a game, in amortised constant time. The moves
+ * which were undone are discarded, as they may no longer be redone. If the log could not be
+ * grown, an error message is printed out and the process is terminated.
+ *
+ * @param state 	[in, out] pointer to the State struct of the game
+ * @param row 		[in] the row number of the cell changed
+ * @param col 		[in] the column number of the cell changed
+ * @param oldValue 	[in] the value of that cell before the move
+ * @param newValue 	[in] the value of that cell after the move
+ */
+void appendMove(State* state, int row, int col, int oldValue, int newValue) {
+	Move* move = NULL;
+
+	if (state->numMovesDone == state->movesCapacity) {
+		int capacity = (state->movesCapacity > 0) ? 2 * state->movesCapacity : INITIAL_MOVE_LOG_CAPACITY;
+		Move* moves = realloc(state->moves, capacity * sizeof(Move));
+		if (moves == NULL) {
+			/* NOTE: for now we are allowed this behaviour: */
+			printf("Error: set has failed\n");
+			exit(EXIT_FAILURE);
+		}
+		state->moves = moves;
+		state->movesCapacity = capacity;
+	}
+
+	move = &(state->moves[state->numMovesDone]);
+	move->cellIndex = (unsigned short)(row * state->puzzle->dimension + col);
+	move->oldValue = (unsigned char)oldValue;
+	move->newValue = (unsigned char)newValue;
+	state->numMovesDone++;
+	state->numMoves = state->numMovesDone;
 }
 
 bool set(State* state, int row, int col, int value, SetErrorType* errorTypeOut) {
-	if (isCellFixed(&(state->puzzle), row, col)) {
+	int oldValue = 0;
+
+	if (isCellFixed(state->puzzle, row, col)) {
 		*errorTypeOut = VALUE_FIXED;
 		return false;
 	}
-	if (value != EMPTY_CELL_VALUE) {
-		if (! isCellValueValid(&(state->puzzle), row, col, value)) {
-			*errorTypeOut = VALUE_INVALID;
-			return false;
-		} else {
-			setPuzzleCell(state, row, col, value);
-		}
-	} else {
-		emptyPuzzleCell(state, row, col);
+	if (value != EMPTY_CELL_VALUE && ! isCellValueValid(state->puzzle, row, col, value)) {
+		*errorTypeOut = VALUE_INVALID;
+		return false;
+	}
+
+	oldValue = getCellValue(state->puzzle, row, col);
+	if (value != oldValue) {
+		appendMove(state, row, col, oldValue, value);
+		changePuzzleCell(state, row, col, value);
 	}
 
 	return true;
 }
 
+bool undo(State* state) {
+	Move* move = NULL;
+	int dimension = state->puzzle->dimension;
+
+	if (state->numMovesDone == 0) {
+		return false;
+	}
+
+	state->numMovesDone--;
+	move = &(state->moves[state->numMovesDone]);
+	changePuzzleCell(state, move->cellIndex / dimension, move->cellIndex % dimension, move->oldValue);
+	return true;
+}
+
+bool redo(State* state) {
+	Move* move = NULL;
+	int dimension = state->puzzle->dimension;
+
+	if (state->numMovesDone == state->numMoves) {
+		return false;
+	}
+
+	move = &(state->moves[state->numMovesDone]);
+	changePuzzleCell(state, move->cellIndex / dimension, move->cellIndex % dimension, move->newValue);
+	state->numMovesDone++;
+	return true;
+}
+
 bool isGameWon(State* state) {
 	return state->numNonSet == 0;
 }
 
 int hint(State* state, int row, int col) {
-	return getCellValue(&(state->solution), row, col);
+	return getCellValue(state->solution, row, col);
 }
 
-/**
- * randomlyFixCells is to be used in ordered to randomly mark a certain
- * amount of cells in a given board as fixed.
- * Canonical use of this function: generation of a puzzle board.
- * 
- * @param board				[in, out] the board whose cells are to be fixed
- * @param numCellsToFix 	[in] the number of cells to fix (should be not more
- * 							than the number of cells in board)
- */
-void randomlyFixCells(Board* board, int numCellsToFix) {
+void randomlyFixCells(Board* board, int numCellsToFix, RandomGenerator* generator) {
 	int fixCount = 0;
 	while (fixCount < numCellsToFix) {
-		int col = rand() % N_SQUARE;
-		int row = rand() % N_SQUARE;
+		int col = getRandomIndex(generator, board->dimension);
+		int row = getRandomIndex(generator, board->dimension);
 
 		if (! isCellFixed(board, row, col)) {
 			fixCell(board, row, col);
@@ -215,40 +415,95 @@ void randomlyFixCells(Board* board, int numCellsToFix) {
  */
 void clearNonFixedCells(Board* board) {
 	int row = 0, col = 0;
-	for (row = 0; row < N_SQUARE; row++)
-		for (col = 0; col < N_SQUARE; col++)
+	for (row = 0; row < board->dimension; row++)
+		for (col = 0; col < board->dimension; col++)
 			if (! isCellFixed(board, row, col))
 				emptyCell(board, row, col);
 }
 
-bool initialise(int numCellsToFill, State** stateOut, Board* board) {
-	*stateOut = calloc(1, sizeof(State));
-	if (*stateOut == NULL) {
+/**
+ * allocateState allocates a new State struct, along with its boards. If allocation fails, an
+ * error message is printed out and the process is terminated.
+ *
+ * @param blockSize		[in] the block size of the boards of the game
+ * @return State*		a pointer to the new State struct
+ */
+State* allocateState(int blockSize) {
+	State* state = calloc(1, sizeof(State));
+	if (state == NULL) {
 		/* NOTE: for now we are allowed this behaviour: */
 		printf("Error: initialise has failed\n");
 		exit(EXIT_FAILURE);
-		return false;
 	}
+	state->puzzle = createBoard(blockSize);
+	state->solution = createBoard(blockSize);
+	return state;
+}
+
+bool initialise(int numCellsToFill, State** stateOut, Board* board, RandomGenerator* generator) {
+	int dimension = getBoardDimension(board);
 
-	(*stateOut)->puzzle = *board;
+	*stateOut = allocateState(getBlockSize(board));
 
-	randomlyFixCells(&((*stateOut)->puzzle), numCellsToFill);
+	copyBoard((*stateOut)->puzzle, board);
 
-	(*stateOut)->solution = (*stateOut)->puzzle;
+	randomlyFixCells((*stateOut)->puzzle, numCellsToFill, generator);
 
-	clearNonFixedCells(&((*stateOut)->puzzle));
+	copyBoard((*stateOut)->solution, (*stateOut)->puzzle);
 
-	(*stateOut)->numNonSet = N_SQUARE * N_SQUARE - numCellsToFill;
+	clearNonFixedCells((*stateOut)->puzzle);
+
+	(*stateOut)->numNonSet = dimension * dimension - numCellsToFill;
+
+	return true;
+}
+
+bool initialiseWithFixedCells(State** stateOut, Board* board) {
+	int row = 0, col = 0;
+	int dimension = getBoardDimension(board);
+
+	*stateOut = allocateState(getBlockSize(board));
+
+	copyBoard((*stateOut)->puzzle, board);
+	copyBoard((*stateOut)->solution, board);
+
+	clearNonFixedCells((*stateOut)->puzzle);
+
+	for (row = 0; row < dimension; row++)
+		for (col = 0; col < dimension; col++)
+			if (isCellEmpty((*stateOut)->puzzle, row, col))
+				(*stateOut)->numNonSet++;
 
 	return true;
 }
 
 void setPuzzleSolution(State* state, Board* solution) {
-	state->solution = *solution;
+	int dimension = getBoardDimension(solution);
+	int row = 0, col = 0;
+
+	copyBoard(state->solution, solution);
+
+	state->numDeviatingCells = 0;
+	for (row = 0; row < dimension; row++)
+		for (col = 0; col < dimension; col++)
+			if (!isCellEmpty(state->puzzle, row, col) &&
+				getCellValue(state->puzzle, row, col) != getCellValue(solution, row, col))
+				state->numDeviatingCells++;
+}
+
+bool isGameConsistentWithSolution(State* state) {
+	return state->numDeviatingCells == 0;
+}
+
+void exportSolution(State* state, Board* boardOut) {
+	copyBoard(boardOut, state->solution);
 }
 
 void destruct(State* state) {
 	if (state != NULL) {
+		destroyBoard(state->puzzle);
+		destroyBoard(state->solution);
+		free(state->moves);
 		free(state);
 	}
 }
@@ -3,19 +3,38 @@
  *
  * A module designed to allow for a sudoku game to be run from start to finish.
  *
+ * createBoard - allocates a new, empty, sudoku board of a given size
+ * destroyBoard - frees a sudoku board
+ * copyBoard - copies the contents of one sudoku board to another of the same size
+ * clearBoard - empties all the cells of a sudoku board
+ * getBlockSize - returns the size of the side of a block of a board
+ * getBoardDimension - returns the number of rows (and columns) of a board
+ * getGameBlockSize - returns the block size of the board of a sudoku game
  * initialise - Creates a new sudoku game
+ * initialiseWithFixedCells - Creates a new sudoku game whose fixed cells were already chosen
  * destruct - demolishes a sudoku game when it's of no use
  * exportBoard - exports a boarding representing the current state of the game
+ * viewPuzzle - provides read-only access to the current state of the game, without a copy
+ * viewSolution - provides read-only access to the stored solution of the game, without a copy
  * isGameWon - checks whether the game is over
  * getCellValue - returns the value of a specific cell in the board
  * setCellValue - sets the value of a specific cell in the board
  * isCellValueValid - checks if a value is valid for a specific cell in the board
+ * getCellCandidates - returns the values that may be placed in a specific cell of the board
+ * countMaskValues - counts the values in a candidates bitmask
+ * getMaskValue - returns the lowest value in a candidates bitmask
+ * fixCell - marks a certain cell of the board as fixed
+ * randomlyFixCells - marks a certain number of random cells of the board as fixed
  * isCellFixed - checks whether a certain cell is fixed in the board
  * isCellEmpty - checks whether a certain cell is empty (devoid of a value)
  * emptyCell - empties a cell
  * set - used to accommodate a 'set' command from the user
  * hint - used to accommodate a 'hint' command from the user
+ * undo - used to accommodate an 'undo' command from the user
+ * redo - used to accommodate a 'redo' command from the user
  * setPuzzleSolution - sets the stored solution of a sudoku game
+ * isGameConsistentWithSolution - checks whether the filled cells agree with the stored solution
+ * exportSolution - exports the stored solution of a sudoku game
  */
 
 #ifndef GAME_H_
@@ -24,12 +43,19 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+
+#include "random.h"
 
 /**
- * The dimension of the sudoku board are determined by these constants.
+ * The dimension of a sudoku board is determined at runtime by its block size n: the board
+ * has n*n rows, columns and blocks, and its values are within the range [1, n*n].
+ * Values are kept in unsigned int bitmasks, so the block size is limited to MAX_BLOCK_SIZE.
  */
-#define N (3)
-#define N_SQUARE (N*N)
+#define DEFAULT_BLOCK_SIZE (3)
+#define MIN_BLOCK_SIZE (2)
+#define MAX_BLOCK_SIZE (5)
+#define MAX_DIMENSION (MAX_BLOCK_SIZE * MAX_BLOCK_SIZE)
 
 /**
  * The value defined in this constant would mark an empty cell in the sudoku board.
@@ -37,19 +63,86 @@
 #define EMPTY_CELL_VALUE (0)
 
 /**
- * Cell struct represents one cell of a sudoku puzzle board. It contains the value
- * in the cell, and a marker determining whether the cell is fixed (immutable) or not.
+ * Cell represents one cell of a sudoku puzzle board, packed in a single byte. Its low bits
+ * (CELL_VALUE_MASK) hold the value in the cell, and its high bit (CELL_FIXED_FLAG) marks
+ * whether the cell is fixed (immutable) or not. A 9x9 board's cells thus take 81 bytes.
  */
-typedef struct {
-	int value;
-    bool isFixed;} Cell;
+typedef unsigned char Cell;
+
+#define CELL_FIXED_FLAG (0x80)
+#define CELL_VALUE_MASK (0x7F)
 
 /**
- * Board struct represents a sudoku board.
+ * Board struct represents a sudoku board of dimension n*n, where n is its block size.
+ * Alongside the cells themselves (in row-major order), it keeps an occupancy bitmask for
+ * every row, column and block: bit (value - 1) of a mask is on iff that value appears in the
+ * matching row, column or block. The masks are maintained by setCellValue and emptyCell, so
+ * cells should only ever be modified through these.
+ * cellBlocks maps every cell (in row-major order) to the number of the block it belongs to.
+ * A board and all of its arrays live in a single heap block, acquired through createBoard.
+ * Boards must not be assigned to each other; use copyBoard instead.
  */
 typedef struct {
-	Cell cells[N_SQUARE][N_SQUARE];} Board;
-	
+	int blockSize;
+	int dimension;
+	unsigned int* rowMasks;
+	unsigned int* colMasks;
+	unsigned int* blockMasks;
+	Cell* cells;
+	unsigned char* cellBlocks;} Board;
+
+/**
+ * createBoard allocates a new sudoku board, all of whose cells are empty and not fixed.
+ * If allocation fails, an error message is printed out and the process is terminated.
+ *
+ * @param blockSize		[in] the size of the side of a block of the board, within the range
+ * 						[MIN_BLOCK_SIZE, MAX_BLOCK_SIZE]
+ * @return Board*		a pointer to the new board
+ *
+ * @note	you must later call destroyBoard with the pointer returned.
+ */
+Board* createBoard(int blockSize);
+
+/**
+ * destroyBoard frees a sudoku board.
+ *
+ * @param board		[in] a board previously acquired through createBoard
+ */
+void destroyBoard(Board* board);
+
+/**
+ * copyBoard copies the contents (cells and masks) of one sudoku board to another.
+ *
+ * @param dest		[in, out] the board to be overwritten
+ * @param src 		[in] the board to be copied; must have the same block size as dest
+ */
+void copyBoard(Board* dest, const Board* src);
+
+/**
+ * clearBoard empties all the cells of a sudoku board and makes them not fixed, so that the
+ * board may be reused without being reallocated.
+ *
+ * @param board		[in, out] the board to be cleared
+ */
+void clearBoard(Board* board);
+
+/**
+ * getBlockSize returns the size of the side of a block of a sudoku board.
+ *
+ * @param board		[in] pointer to the Board struct
+ * @return int		the block size n of the board
+ */
+int getBlockSize(const Board* board);
+
+/**
+ * getBoardDimension returns the number of rows (which is also the number of columns, blocks
+ * and values) of a sudoku board.
+ *
+ * @param board		[in] pointer to the Board struct
+ * @return int		the dimension n*n of the board
+ */
+int getBoardDimension(const Board* board);
+
 
 /**
  *  State struct represents a sudoku game in its current state.
@@ -65,10 +158,39 @@ typedef struct State State;
  * @param state		[in] the State struct of a sudoku game, the current state of the board
  * 					of which is to be exported
  * @param boardOut 	[in, out] a pointer to a Board struct to be assigned with a representation
- * 					of the current state of the board game
+ * 					of the current state of the board game. It must have the block size of
+ * 					the game (see getGameBlockSize)
  */
 void exportBoard(State* state, Board* boardOut);
 
+/**
+ * viewPuzzle provides read-only access to the board of a sudoku game in its current state,
+ * without copying it. The view reflects every later change to the game, and is valid until
+ * the game is destructed.
+ * Canonical use: rendering the board, or inspecting it, where exportBoard would copy it.
+ *
+ * @param state			[in] the State struct of a sudoku game
+ * @return const Board*	the current board of the game
+ */
+const Board* viewPuzzle(State* state);
+
+/**
+ * viewSolution provides read-only access to the stored solution of a sudoku game, without
+ * copying it. The view is valid until the game is destructed.
+ *
+ * @param state			[in] the State struct of a sudoku game
+ * @return const Board*	the stored solution of the game
+ */
+const Board* viewSolution(State* state);
+
+/**
+ * getGameBlockSize returns the block size of the board of a sudoku game.
+ *
+ * @param state		[in] the State struct of a sudoku game
+ * @return int		the block size of the game's board
+ */
+int getGameBlockSize(State* state);
+
 /**
  * getCellValue returns the value of a particular cell in the sudoku board.
  *
@@ -77,21 +199,50 @@ void exportBoard(State* state, Board* boardOut);
  * @param col 		[in] column number of that cell
  * @return int 		the integer contained in that cell
  */
-int getCellValue(Board* board, int row, int col);
+int getCellValue(const Board* board, int row, int col);
 
 /**
  * isCellValueValid checks the validity of a value assignment in a particular cell. A cell value
  * is valid if that value does not already appear in the row, column or block of the cell in which
  * it's placed OR if it's the exact same the cell already contains.
+ * The check is done against the occupancy bitmasks of the board, in constant time.
  *
  * @param board		[in] pointer to the Board struct to be inspected
  * @param row 		[in] number of row of the cell whose value's validity is checked
  * @param col 		[in] number of row of the cell whose value's validity is checked
- * @param value 	[in] value of that cell (which should be within the range [1, N*N])
+ * @param value 	[in] value of that cell (which should be within the range [1, n*n])
  * @return true 	iff placement of value in the cell is valid
  * @return false 	iff placement of value in the cell is invalid
  */
-bool isCellValueValid(Board* board, int row, int col, int value);
+bool isCellValueValid(const Board* board, int row, int col, int value);
+
+/**
+ * getCellCandidates computes the set of values that could be placed in a particular cell
+ * without conflicting with its row, column or block, ignoring the cell's own current value.
+ *
+ * @param board		[in] pointer to the Board struct to be inspected
+ * @param row 		[in] row number of the cell
+ * @param col 		[in] column number of the cell
+ * @return unsigned int		a bitmask in which bit (value - 1) is on iff value is a candidate
+ * 							for the cell
+ */
+unsigned int getCellCandidates(const Board* board, int row, int col);
+
+/**
+ * countMaskValues counts the number of values in a candidates bitmask (see getCellCandidates).
+ *
+ * @param mask		[in] the candidates bitmask
+ * @return int		the number of bits on in mask
+ */
+int countMaskValues(unsigned int mask);
+
+/**
+ * getMaskValue returns the lowest value of a candidates bitmask.
+ *
+ * @param mask		[in] a non-empty candidates bitmask
+ * @return int		the lowest value whose bit is on in mask
+ */
+int getMaskValue(unsigned int mask);
 
 /**
  * setCellValue is used to set the cell with given indices in the given board with the
@@ -104,6 +255,27 @@ bool isCellValueValid(Board* board, int row, int col, int value);
  */
 void setCellValue(Board* board, int row, int col, int value);
 
+/**
+ * fixCell is used during the generation of a new sudoku board to make a cell fixed.
+ *
+ * @param board		[in, out] pointer to the Board struct whose cell is set to be fixed
+ * @param row 		[in] the row number of that cell
+ * @param col 		[in] the column number of that cell
+ */
+void fixCell(Board* board, int row, int col);
+
+/**
+ * randomlyFixCells is to be used in ordered to randomly mark a certain
+ * amount of cells in a given board as fixed.
+ * Canonical use of this function: generation of a puzzle board.
+ *
+ * @param board				[in, out] the board whose cells are to be fixed
+ * @param numCellsToFix 	[in] the number of cells to fix (should be not more
+ * 							than the number of cells in board)
+ * @param generator 		[in, out] the random generator choosing the cells
+ */
+void randomlyFixCells(Board* board, int numCellsToFix, RandomGenerator* generator);
+
 /**
  * isCellFixed checks whether a particular cell of a sudoku board is a fixed cell or
  * not.
@@ -114,7 +286,7 @@ void setCellValue(Board* board, int row, int col, int value);
  * @return true 	iff the cell with given indices is fixed
  * @return false 	iff the cell with given indices is not fixed
  */
-bool isCellFixed(Board* board, int row, int col);
+bool isCellFixed(const Board* board, int row, int col);
 
 /**
  * isCellEmpty checks whether a particular cell of a sudoku board is empty or not.
@@ -125,7 +297,7 @@ bool isCellFixed(Board* board, int row, int col);
  * @return true 	iff the cell with given indices is empty
  * @return false 	iff the cell with given indices is not empty
  */
-bool isCellEmpty(Board* board, int row, int col);
+bool isCellEmpty(const Board* board, int row, int col);
 
 /**
  * emptyCell empties a particular cell in a sudoku board.
@@ -165,6 +337,29 @@ typedef enum setErrorType {
  */
 bool set(State* state, int row, int col, int value, SetErrorType* errorTypeOut);
 
+/**
+ * undo is used to update the game after an 'undo' command from the user. It reverts the last
+ * move made through set which was not undone yet, restoring the previous value of its cell.
+ * Every move of the game is kept, so any number of moves may be undone.
+ * A successful set which changed a cell counts as one move; a new move discards the moves
+ * which were undone, so they may no longer be redone.
+ *
+ * @param state 	[in, out] a pointer to the State struct of the game
+ * @return true 	iff a move was undone
+ * @return false 	iff there were no moves to undo
+ */
+bool undo(State* state);
+
+/**
+ * redo is used to update the game after a 'redo' command from the user. It makes again the
+ * last move reverted by undo (and not discarded since).
+ *
+ * @param state 	[in, out] a pointer to the State struct of the game
+ * @return true 	iff a move was redone
+ * @return false 	iff there were no moves to redo
+ */
+bool redo(State* state);
+
 /**
  * isGameWon checks if a sudoku game in its current state is finished by checking if
  * all of its cells are filled.
@@ -195,14 +390,33 @@ int hint(State* state, int row, int col);
  * @param stateOut 			[in, out] a pointer to a State struct pointer. This
  * 							will be used to pass a valid pointer to a sudoku game
  * 							struct, through which the game being initialised can be handled.
- * @param board 			[in] the puzzle which will be the initial state of the game
+ * @param board 			[in] the puzzle which will be the initial state of the game. The
+ * 							game gets the same block size as this board
+ * @param generator 		[in, out] the random generator choosing the fixed cells
  * @return true 			iff the initialisation succeeded
  * @return false 			iff the initialisation failed
  *
  * @note	if initialise succeeded, you must later call destruct with the pointer
  * 			returned through stateOut.
  */
-bool initialise(int numCellsToFill, State** stateOut, Board* board);
+bool initialise(int numCellsToFill, State** stateOut, Board* board, RandomGenerator* generator);
+
+/**
+ * initialiseWithFixedCells is used in order to initialise a sudoku game whose fixed cells
+ * were already marked in the provided board (see fixCell), rather than selected at random.
+ *
+ * @param stateOut 			[in, out] a pointer to a State struct pointer. This
+ * 							will be used to pass a valid pointer to a sudoku game
+ * 							struct, through which the game being initialised can be handled.
+ * @param board 			[in] a completely filled board, whose fixed cells make up the
+ * 							puzzle which will be the initial state of the game
+ * @return true 			iff the initialisation succeeded
+ * @return false 			iff the initialisation failed
+ *
+ * @note	if initialiseWithFixedCells succeeded, you must later call destruct with the pointer
+ * 			returned through stateOut.
+ */
+bool initialiseWithFixedCells(State** stateOut, Board* board);
 
 /**
  * setPuzzleSolution is used to set the stored solution of a sudoku game
@@ -214,6 +428,27 @@ bool initialise(int numCellsToFill, State** stateOut, Board* board);
  */
 void setPuzzleSolution(State* state, Board* solution);
 
+/**
+ * isGameConsistentWithSolution checks, in constant time, whether every filled cell of the
+ * game holds the value of the stored solution. The game keeps count of the cells which do
+ * not, as cells are set and emptied and as the stored solution is replaced.
+ * Canonical use: a consistent game is known to be solvable without solving it again.
+ *
+ * @param state		[in] a pointer to the State struct of the game
+ * @return true 	iff no filled cell deviates from the stored solution
+ * @return false 	iff some filled cell holds a value other than the stored solution's
+ */
+bool isGameConsistentWithSolution(State* state);
+
+/**
+ * exportSolution exports the stored solution of a sudoku game via boardOut.
+ *
+ * @param state		[in] the State struct of a sudoku game
+ * @param boardOut 	[in, out] a pointer to a Board struct to be assigned with the stored
+ * 					solution. It must have the block size of the game
+ */
+void exportSolution(State* state, Board* boardOut);
+
 /**
  * destruct is used to free resourced needed for the game.
  *
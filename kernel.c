@@ -0,0 +1,157 @@
+#include "kernel.h"
+
+/**
+ * DEFINE_SEARCH_KERNEL instantiates the search kernel for boards of block size n. With
+ * DIM_n standing for n*n, it defines:
+ *
+ * KernelSearch_n		- the state of a search: occupancy masks, cell values, the worklist of
+ * 						  empty cells, the first solution found, and the counters and budget of
+ * 						  the search
+ * kernelCell_n			- the row, column and block of a cell index, by constant division
+ * kernelIsValid_n		- the validity check of a value in a cell
+ * kernelCandidates_n	- the candidates bitmask of a cell
+ * kernelPlace_n		- places a value in a cell (or empties it, with value 0)
+ * kernelSearchRec_n	- the recursive minimum remaining values search
+ * kernelSearch_n		- loads a Board into a KernelSearch_n, searches, and writes back the
+ * 						  solution
+ */
+#define DEFINE_SEARCH_KERNEL(n)																	\
+																								\
+typedef struct {																				\
+	unsigned int rowMasks[(n) * (n)];															\
+	unsigned int colMasks[(n) * (n)];															\
+	unsigned int blockMasks[(n) * (n)];															\
+	unsigned char values[(n) * (n) * (n) * (n)];												\
+	unsigned char solution[(n) * (n) * (n) * (n)];												\
+	short emptyCells[(n) * (n) * (n) * (n)];													\
+	int numSolutions;																			\
+	int numInitialEmptyCells;																	\
+	SolverStats* stats;																			\
+	int limit;																					\
+} KernelSearch_##n;																				\
+																								\
+void kernelCell_##n(int cell, int* rowOut, int* colOut, int* blockOut) {						\
+	*rowOut = cell / ((n) * (n));																\
+	*colOut = cell % ((n) * (n));																\
+	*blockOut = ((*rowOut / (n)) * (n)) + (*colOut / (n));										\
+}																								\
+																								\
+unsigned int kernelCandidates_##n(KernelSearch_##n* search, int cell) {							\
+	int row = 0, col = 0, block = 0;															\
+	kernelCell_##n(cell, &row, &col, &block);													\
+	return ((1u << ((n) * (n))) - 1) &															\
+		   ~(search->rowMasks[row] | search->colMasks[col] | search->blockMasks[block]);		\
+}																								\
+																								\
+bool kernelIsValid_##n(KernelSearch_##n* search, int cell, int value) {							\
+	return (kernelCandidates_##n(search, cell) & (1u << (value - 1))) != 0;						\
+}																								\
+																								\
+void kernelPlace_##n(KernelSearch_##n* search, int cell, int value) {							\
+	int row = 0, col = 0, block = 0;															\
+	unsigned int oldBit = (search->values[cell] == 0) ? 0 : 1u << (search->values[cell] - 1);	\
+	unsigned int newBit = (value == 0) ? 0 : 1u << (value - 1);									\
+	kernelCell_##n(cell, &row, &col, &block);													\
+	search->rowMasks[row] = (search->rowMasks[row] & ~oldBit) | newBit;							\
+	search->colMasks[col] = (search->colMasks[col] & ~oldBit) | newBit;							\
+	search->blockMasks[block] = (search->blockMasks[block] & ~oldBit) | newBit;					\
+	search->values[cell] = (unsigned char)value;												\
+}																								\
+																								\
+bool kernelSearchRec_##n(KernelSearch_##n* search, int numEmptyCells) {							\
+	unsigned int candidates = 0, bestCandidates = 0;											\
+	int i = 0, bestIndex = 0, bestCount = (n) * (n) + 1, cell = 0, value = 0;					\
+																								\
+	if (numEmptyCells == 0) {																	\
+		if (search->numSolutions++ == 0)														\
+			memcpy(search->solution, search->values, sizeof(search->values));					\
+		return search->numSolutions >= search->limit;											\
+	}																							\
+																								\
+	for (i = 0; i < numEmptyCells; i++) {														\
+		int count = 0;																			\
+		candidates = kernelCandidates_##n(search, search->emptyCells[i]);						\
+		search->stats->numValidityChecks++;														\
+		count = countMaskValues(candidates);														\
+		if (count < bestCount) {																\
+			bestIndex = i;																		\
+			bestCount = count;																	\
+			bestCandidates = candidates;														\
+			if (count <= 1)																		\
+				break;																			\
+		}																						\
+	}																							\
+	if (bestCount == 0) {																		\
+		search->stats->numBacktracks++;															\
+		return false;																			\
+	}																							\
+																								\
+	cell = search->emptyCells[bestIndex];														\
+	search->emptyCells[bestIndex] = search->emptyCells[numEmptyCells - 1];						\
+	search->emptyCells[numEmptyCells - 1] = (short)cell;										\
+																								\
+	for (value = 1; value <= (n) * (n) && !search->stats->hasGivenUp; value++) {				\
+		if ((bestCandidates & (1u << (value - 1))) &&											\
+			recordSearchNode(search->stats, search->numInitialEmptyCells - numEmptyCells + 1)) {	\
+			kernelPlace_##n(search, cell, value);												\
+			if (kernelSearchRec_##n(search, numEmptyCells - 1)) {								\
+				kernelPlace_##n(search, cell, 0);												\
+				return true;																	\
+			}																					\
+		}																						\
+	}																							\
+	kernelPlace_##n(search, cell, 0);															\
+	if (!search->stats->hasGivenUp)																\
+		search->stats->numBacktracks++;															\
+	return false;																				\
+}																								\
+																								\
+int kernelSearch_##n(Board* board, int limit, bool shouldFill, SolverStats* statsInOut) {		\
+	KernelSearch_##n search;																	\
+	SolverStats localStats;																		\
+	int numEmptyCells = 0, cell = 0;															\
+																								\
+	memset(&search, 0, sizeof(search));															\
+	search.limit = limit;																		\
+	resetSolverStats(&localStats);																\
+	search.stats = (statsInOut != NULL) ? statsInOut : &localStats;								\
+	for (cell = 0; cell < (n) * (n) * (n) * (n); cell++) {										\
+		int value = getCellValue(board, cell / ((n) * (n)), cell % ((n) * (n)));				\
+		if (value == EMPTY_CELL_VALUE)															\
+			search.emptyCells[numEmptyCells++] = (short)cell;									\
+		else if (kernelIsValid_##n(&search, cell, value))										\
+			kernelPlace_##n(&search, cell, value);												\
+		else																					\
+			return 0;																			\
+	}																							\
+																								\
+	search.numInitialEmptyCells = numEmptyCells;												\
+	kernelSearchRec_##n(&search, numEmptyCells);												\
+																								\
+	if (shouldFill && search.numSolutions > 0)													\
+		for (cell = 0; cell < (n) * (n) * (n) * (n); cell++)									\
+			if (search.values[cell] == EMPTY_CELL_VALUE)										\
+				setCellValue(board, cell / ((n) * (n)), cell % ((n) * (n)),						\
+							 search.solution[cell]);											\
+																								\
+	return search.numSolutions;																	\
+}
+
+DEFINE_SEARCH_KERNEL(2)
+DEFINE_SEARCH_KERNEL(3)
+DEFINE_SEARCH_KERNEL(4)
+DEFINE_SEARCH_KERNEL(5)
+
+int searchWithKernel(Board* board, int limit, bool shouldFill, SolverStats* statsInOut) {
+	switch (getBlockSize(board)) {
+	case 2:
+		return kernelSearch_2(board, limit, shouldFill, statsInOut);
+	case 3:
+		return kernelSearch_3(board, limit, shouldFill, statsInOut);
+	case 4:
+		return kernelSearch_4(board, limit, shouldFill, statsInOut);
+	case 5:
+		return kernelSearch_5(board, limit, shouldFill, statsInOut);
+	}
+	return 0;
+}
@@ -0,0 +1,35 @@
+/**
+ * KERNEL Summary:
+ *
+ * A module providing search kernels specialized for each supported board size. For every block
+ * size n in [MIN_BLOCK_SIZE, MAX_BLOCK_SIZE], a separate copy of the validity check, the candidate
+ * computation and the minimum remaining values search loop is instantiated from a single macro,
+ * with the loop bounds and mask widths as compile time constants. A dispatcher selects the copy
+ * matching the size of the board it is given.
+ *
+ * searchWithKernel - solves a board, or counts its solutions, with the specialized kernel
+ */
+
+#ifndef KERNEL_H_
+#define KERNEL_H_
+
+#include "game.h"
+#include "stats.h"
+
+/**
+ * searchWithKernel runs the minimum remaining values search on a board, using the kernel
+ * specialized for its size. The search stops once limit solutions have been found. If at least
+ * one solution was found and shouldFill is set, the empty cells of the board are filled with the
+ * first solution found; otherwise the board is left unchanged.
+ *
+ * @param board			[in, out] pointer to the Board struct to be searched
+ * @param limit 		[in] the number of solutions at which the search stops (at least 1)
+ * @param shouldFill 	[in] whether the first solution found should be written to board
+ * @param statsInOut 	[in, out] if not NULL, the counters the work of the search is added to.
+ * 						Their budget applies to the search, which stops (leaving the board
+ * 						unchanged) once it is exhausted
+ * @return int			the number of solutions found, at most limit
+ */
+int searchWithKernel(Board* board, int limit, bool shouldFill, SolverStats* statsInOut);
+
+#endif /* KERNEL_H_ */
@@ -1,18 +1,149 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #include "SPBufferset.h"
+#include "batch.h"
 #include "main_aux.h"
 
 int main(int argc, char** argv) {
+	unsigned long seed = (unsigned long)time(NULL);
+	int blockSize = DEFAULT_BLOCK_SIZE;
+	char* batchInputPath = NULL;
+	char* convertInputPath = NULL;
+	char* replayPath = NULL;
+	char* rateInputPath = NULL;
+	char* outputPath = "-";
+	int numThreads = getNumProcessors();
+	bool isDeterministic = false;
+	bool isUnique = false;
+	long numPuzzlesToGenerate = 0;
+	int numClues = -1;
+	long maxNodes = 0;
+	double maxSeconds = DEFAULT_GAME_SEARCH_SECONDS;
+	int i = 0;
+
 	SP_BUFF_SET();
-	
-	if (argc > 1) {
-		int seed = atoi(argv[1]);
-		srand(seed);
-	} else {
-		srand(time(NULL));
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--engine") == 0) {
+			SolverEngine engine = BACKTRACKING_ENGINE;
+			if ((i + 1 == argc) || !parseSolverEngine(argv[i + 1], &engine)) {
+				printf("Error: --engine expects one of: backtracking, mrv, dlx, iterative, parallel\n");
+				return EXIT_FAILURE;
+			}
+			setSolverEngine(engine);
+			i++;
+		} else if (strcmp(argv[i], "--quiet") == 0) {
+			BoardOutputMode mode = BOARD_OUTPUT_COMPACT;
+			if ((i + 1 == argc) || !parseBoardOutputMode(argv[i + 1], &mode) || mode == BOARD_OUTPUT_GRID) {
+				printf("Error: --quiet expects one of: compact, diff\n");
+				return EXIT_FAILURE;
+			}
+			setBoardOutputMode(mode);
+			i++;
+		} else if (strcmp(argv[i], "--size") == 0) {
+			if ((i + 1 == argc) || !setGameBlockSize(atoi(argv[i + 1]))) {
+				printf("Error: --size expects a block size between %d and %d\n", MIN_BLOCK_SIZE, MAX_BLOCK_SIZE);
+				return EXIT_FAILURE;
+			}
+			blockSize = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--solve-batch") == 0 || strcmp(argv[i], "--convert") == 0 ||
+				   strcmp(argv[i], "--replay") == 0 || strcmp(argv[i], "--rate") == 0 ||
+				   strcmp(argv[i], "--output") == 0) {
+			if (i + 1 == argc) {
+				printf("Error: %s expects a file path\n", argv[i]);
+				return EXIT_FAILURE;
+			}
+			if (strcmp(argv[i], "--solve-batch") == 0) {
+				batchInputPath = argv[i + 1];
+			} else if (strcmp(argv[i], "--convert") == 0) {
+				convertInputPath = argv[i + 1];
+			} else if (strcmp(argv[i], "--replay") == 0) {
+				replayPath = argv[i + 1];
+			} else if (strcmp(argv[i], "--rate") == 0) {
+				rateInputPath = argv[i + 1];
+			} else {
+				outputPath = argv[i + 1];
+			}
+			i++;
+		} else if (strcmp(argv[i], "--threads") == 0) {
+			if ((i + 1 == argc) || atoi(argv[i + 1]) < 1) {
+				printf("Error: --threads expects a positive number of threads\n");
+				return EXIT_FAILURE;
+			}
+			numThreads = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--generate") == 0) {
+			if ((i + 1 == argc) || atol(argv[i + 1]) < 1) {
+				printf("Error: --generate expects a positive number of puzzles\n");
+				return EXIT_FAILURE;
+			}
+			numPuzzlesToGenerate = atol(argv[++i]);
+		} else if (strcmp(argv[i], "--clues") == 0) {
+			if ((i + 1 == argc) || atoi(argv[i + 1]) < 0) {
+				printf("Error: --clues expects a non-negative number of clues\n");
+				return EXIT_FAILURE;
+			}
+			numClues = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--max-nodes") == 0) {
+			if ((i + 1 == argc) || atol(argv[i + 1]) < 0) {
+				printf("Error: --max-nodes expects a non-negative number of nodes (0 for no limit)\n");
+				return EXIT_FAILURE;
+			}
+			maxNodes = atol(argv[++i]);
+		} else if (strcmp(argv[i], "--max-seconds") == 0) {
+			if ((i + 1 == argc) || atof(argv[i + 1]) < 0) {
+				printf("Error: --max-seconds expects a non-negative number of seconds (0 for no limit)\n");
+				return EXIT_FAILURE;
+			}
+			maxSeconds = atof(argv[++i]);
+		} else if (strcmp(argv[i], "--propagate") == 0) {
+			setConstraintPropagation(true);
+		} else if (strcmp(argv[i], "--deterministic") == 0) {
+			isDeterministic = true;
+		} else if (strcmp(argv[i], "--unique") == 0) {
+			setUniquePuzzleGeneration(true);
+			isUnique = true;
+		} else if (argv[i][0] != '\0' && strspn(argv[i], "0123456789") == strlen(argv[i])) {
+			seed = (unsigned long)atol(argv[i]);
+		} else {
+			printf("Error: unknown option %s\n", argv[i]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	setParallelSearch(numThreads, isDeterministic);
+
+	setGameSeed(seed);
+	setGameSearchBudget(maxNodes, maxSeconds);
+
+	if (numPuzzlesToGenerate > 0) {
+		if (numClues < 0) {
+			printf("Error: --generate expects a number of clues (--clues)\n");
+			return EXIT_FAILURE;
+		}
+		return runGenerateBatch(outputPath, blockSize, numPuzzlesToGenerate, numClues, isUnique, seed, numThreads) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if (replayPath != NULL) {
+		return runReplay(replayPath) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if (convertInputPath != NULL) {
+		return runConvertBatch(convertInputPath, outputPath, blockSize) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if (rateInputPath != NULL) {
+		return runRateBatch(rateInputPath, outputPath, blockSize, numThreads) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if (batchInputPath != NULL) {
+		if (!isBatchSolvingSupported()) {
+			printf("Error: --solve-batch supports the backtracking and mrv engines only, without --propagate\n");
+			return EXIT_FAILURE;
+		}
+		return runSolveBatch(batchInputPath, outputPath, blockSize, numThreads) ? EXIT_SUCCESS : EXIT_FAILURE;
 	}
 
 	while (true) {
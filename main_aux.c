@@ -2,68 +2,275 @@
 
 #define COMMAND_MAX_LENGTH (1024)
 
-#define CELL_SIZE_IN_PRINT (3)
+#define CELL_OVERHEAD_SIZE_IN_PRINT (2)
 #define BLOCK_OVERHEAD_SIZE_IN_PRINT (2)
 #define LINE_OVERHEAD_SIZE_IN_PRINT (1)
 
 /**
- * printSeparatorLine calculates the number of dashes in a line separator of a sudoku board
- * of size N, and prints the separating line.
- * 
+ * The maximal number of characters printBoard writes at once, for a board of the largest size:
+ * the larger of grid mode (its lines, separators included, each with a newline) and diff mode
+ * with every cell changed (a line "row column value" of up to DIFF_LINE_MAX_LENGTH characters
+ * per cell). Compact mode needs less than either.
+ */
+#define BOARD_LINE_MAX_LENGTH (MAX_BLOCK_SIZE * (MAX_BLOCK_SIZE * (CELL_OVERHEAD_SIZE_IN_PRINT + 2) + BLOCK_OVERHEAD_SIZE_IN_PRINT) + LINE_OVERHEAD_SIZE_IN_PRINT + 1)
+#define BOARD_GRID_TEXT_MAX_LENGTH ((MAX_DIMENSION + MAX_BLOCK_SIZE + 1) * BOARD_LINE_MAX_LENGTH)
+#define DIFF_LINE_MAX_LENGTH (sizeof("25 25 25\n") - 1)
+#define BOARD_DIFF_TEXT_MAX_LENGTH (MAX_DIMENSION * MAX_DIMENSION * DIFF_LINE_MAX_LENGTH)
+#define BOARD_TEXT_MAX_LENGTH ((BOARD_GRID_TEXT_MAX_LENGTH > BOARD_DIFF_TEXT_MAX_LENGTH) ? \
+							   BOARD_GRID_TEXT_MAX_LENGTH : BOARD_DIFF_TEXT_MAX_LENGTH)
+
+/**
+ * Whether new games are generated so that their puzzle has a unique solution
+ * (see setUniquePuzzleGeneration).
+ */
+static bool isUniqueGenerationEnabled = false;
+
+/**
+ * The block size of the boards of new games (see setGameBlockSize).
+ */
+static int gameBlockSize = DEFAULT_BLOCK_SIZE;
+
+/**
+ * The random generator used to generate new games (see setGameSeed).
+ */
+static RandomGenerator gameGenerator;
+
+/**
+ * The budget of the searches made by the game, for generating a new game and for the
+ * 'validate' command (see setGameSearchBudget).
+ */
+static SearchBudget gameBudget = {0, DEFAULT_GAME_SEARCH_SECONDS};
+
+/**
+ * The counters of the search of the last 'validate' command, and of the last generation of a
+ * game, for the 'stats' command. Each is only meaningful once its flag is set.
+ */
+static SolverStats lastValidateStats;
+static bool hasValidated = false;
+static SolverStats lastGenerateStats;
+static bool hasGenerated = false;
+
+/**
+ * The format boards are printed in (see setBoardOutputMode).
+ */
+static BoardOutputMode boardOutputMode = BOARD_OUTPUT_GRID;
+
+/**
+ * The values of the board last printed since the game began, in row-major order, which
+ * BOARD_OUTPUT_DIFF prints the changes from. Only meaningful once hasPrintedBoard is set.
  */
-void printSeparatorLine() {
-	int numDashes = N * (N * CELL_SIZE_IN_PRINT + BLOCK_OVERHEAD_SIZE_IN_PRINT) + LINE_OVERHEAD_SIZE_IN_PRINT;
-	for (; numDashes > 0; numDashes--) {
-		printf("-");
+static int lastPrintedValues[MAX_DIMENSION * MAX_DIMENSION];
+static bool hasPrintedBoard = false;
+
+/**
+ * The stream the game reads its input from: a replayed script (see runReplay), or stdin if
+ * NULL. While a script is replayed, only errors are printed, and the commands are counted.
+ */
+static FILE* gameInput = NULL;
+static bool isReplaying = false;
+static ReplayCounters replayCounters;
+
+/**
+ * getGameInput returns the stream the game reads its input from.
+ *
+ * @return FILE*	the script being replayed, or stdin
+ */
+FILE* getGameInput() {
+	return (gameInput != NULL) ? gameInput : stdin;
+}
+
+/**
+ * printGameMessage prints a message of the game which is not an error, such as a prompt, a
+ * board or the result of a command. Nothing is printed while a script is replayed.
+ *
+ * @param format	[in] the format of the message, as for printf
+ * @param ... 		[in] the values of the format
+ */
+void printGameMessage(const char* format, ...) {
+	va_list arguments;
+
+	if (isReplaying) {
+		return;
 	}
-	printf("\n");
+
+	va_start(arguments, format);
+	vprintf(format, arguments);
+	va_end(arguments);
+}
+
+/**
+ * getValueWidthInPrint calculates the number of characters needed to print the largest value
+ * of a sudoku board.
+ *
+ * @param board		[in] the board to be printed
+ * @return int		the number of digits of the board's largest value
+ */
+int getValueWidthInPrint(const Board* board) {
+	return (getBoardDimension(board) > 9) ? 2 : 1;
+}
+
+/**
+ * renderSeparatorLine calculates the number of dashes in a line separator of a given sudoku
+ * board, and writes the separating line to a buffer.
+ * 
+ * @param board		[in] the board whose separator line will be rendered
+ * @param textOut 	[out] the buffer the line is written to
+ * @return int		the number of characters written
+ */
+int renderSeparatorLine(const Board* board, char* textOut) {
+	int blockSize = getBlockSize(board);
+	int cellSize = CELL_OVERHEAD_SIZE_IN_PRINT + getValueWidthInPrint(board);
+	int numDashes = blockSize * (blockSize * cellSize + BLOCK_OVERHEAD_SIZE_IN_PRINT) + LINE_OVERHEAD_SIZE_IN_PRINT;
+	memset(textOut, '-', numDashes);
+	textOut[numDashes] = '\n';
+	return numDashes + 1;
 }
 
 /**
- * printLine prints an individual line of a given sudoku board, according to the format.
+ * renderLine writes an individual line of a given sudoku board to a buffer, according to the
+ * format.
  * 
- * @param board			[in] the board whose line will be printed 
- * @param lineIndex 	[in] the index of the line to be printed
+ * @param board			[in] the board whose line will be rendered
+ * @param lineIndex 	[in] the index of the line to be rendered
+ * @param textOut 		[out] the buffer the line is written to
+ * @return int			the number of characters written
  */
-void printLine(Board* board, int lineIndex) {
+int renderLine(const Board* board, int lineIndex, char* textOut) {
+	int blockSize = getBlockSize(board);
+	int valueWidth = getValueWidthInPrint(board);
+	char* text = textOut;
 	int col = 0;
 
-	printf("|");
+	*(text++) = '|';
 
-	for (col = 0; col < N_SQUARE; col++) {
-		printf(" ");
-		printf("%c", isCellFixed(board, lineIndex, col) ? '.' : ' ');
-		if (! isCellEmpty(board, lineIndex, col)) {
-			printf("%d", getCellValue(board, lineIndex, col));
+	for (col = 0; col < getBoardDimension(board); col++) {
+		int value = getCellValue(board, lineIndex, col);
+
+		*(text++) = ' ';
+		*(text++) = isCellFixed(board, lineIndex, col) ? '.' : ' ';
+		if (value == EMPTY_CELL_VALUE) {
+			memset(text, ' ', valueWidth);
 		} else {
-			printf(" ");
+			/* right-aligned, as printf's "%*d" would */
+			if (valueWidth == 2) {
+				text[0] = (value >= 10) ? (char)('0' + value / 10) : ' ';
+			}
+			text[valueWidth - 1] = (char)('0' + value % 10);
 		}
+		text += valueWidth;
 
-		if ((col % N) == N - 1) {
-			printf(" ");
-			printf("|");
+		if ((col % blockSize) == blockSize - 1) {
+			*(text++) = ' ';
+			*(text++) = '|';
 		}
 	}
 
-	printf("\n");
+	*(text++) = '\n';
+	return (int)(text - textOut);
 }
 
 /**
- * printBoard prints out the current state of the game board according to the format.
+ * renderBoard writes the board, as printed in grid mode, to a buffer.
  * 
- * @param board		[in] a pointer to the sudoku board to be printed out 
+ * @param board		[in] the board to be rendered
+ * @param textOut 	[out] a buffer of at least BOARD_TEXT_MAX_LENGTH characters
+ * @return int		the number of characters written
  */
-void printBoard(Board* board) {
+int renderBoard(const Board* board, char* textOut) {
+	int blockSize = getBlockSize(board);
+	int length = 0;
 	int row = 0;
 
-	printSeparatorLine();
+	length += renderSeparatorLine(board, textOut + length);
 
-	for (row = 0; row < N_SQUARE; row++) {
-		printLine(board, row);
-		if ((row % N) == N - 1) {
-			printSeparatorLine();
+	for (row = 0; row < getBoardDimension(board); row++) {
+		length += renderLine(board, row, textOut + length);
+		if ((row % blockSize) == blockSize - 1) {
+			length += renderSeparatorLine(board, textOut + length);
 		}
 	}
+
+	return length;
+}
+
+/**
+ * renderCompactBoard writes the board as a single line, one character per cell (see
+ * formatBoard), to a buffer.
+ * 
+ * @param board		[in] the board to be rendered
+ * @param textOut 	[out] a buffer of at least BOARD_TEXT_MAX_LENGTH characters
+ * @return int		the number of characters written
+ */
+int renderCompactBoard(const Board* board, char* textOut) {
+	int length = formatBoard(board, textOut);
+	textOut[length] = '\n';
+	return length + 1;
+}
+
+/**
+ * renderBoardDiff writes a line "row column value" (1-based, 0 for an empty cell) for every
+ * cell whose value differs from the board last printed, to a buffer. If no board was printed
+ * since the game began, the whole board is written as in compact mode instead.
+ * 
+ * @param board		[in] the board to be rendered
+ * @param textOut 	[out] a buffer of at least BOARD_TEXT_MAX_LENGTH characters
+ * @return int		the number of characters written
+ */
+int renderBoardDiff(const Board* board, char* textOut) {
+	int dimension = getBoardDimension(board);
+	int length = 0;
+	int row = 0, col = 0;
+
+	if (!hasPrintedBoard) {
+		return renderCompactBoard(board, textOut);
+	}
+
+	for (row = 0; row < dimension; row++) {
+		for (col = 0; col < dimension; col++) {
+			int value = getCellValue(board, row, col);
+			if (value != lastPrintedValues[row * dimension + col]) {
+				length += sprintf(textOut + length, "%d %d %d\n", row + 1, col + 1, value);
+			}
+		}
+	}
+
+	return length;
+}
+
+/**
+ * printBoard prints out the current state of the game board according to the format selected
+ * (see setBoardOutputMode). The board is rendered into a preallocated buffer first, and
+ * printed with a single write, as stdout is unbuffered.
+ * 
+ * @param board		[in] a pointer to the sudoku board to be printed out 
+ */
+void printBoard(const Board* board) {
+	static char boardText[BOARD_TEXT_MAX_LENGTH];
+	int dimension = getBoardDimension(board);
+	int length = 0;
+	int row = 0, col = 0;
+
+	if (isReplaying) {
+		return;
+	}
+
+	switch (boardOutputMode) {
+	case BOARD_OUTPUT_COMPACT:
+		length = renderCompactBoard(board, boardText);
+		break;
+	case BOARD_OUTPUT_DIFF:
+		length = renderBoardDiff(board, boardText);
+		break;
+	case BOARD_OUTPUT_GRID:
+		length = renderBoard(board, boardText);
+		break;
+	}
+	fwrite(boardText, sizeof(char), length, stdout);
+
+	for (row = 0; row < dimension; row++)
+		for (col = 0; col < dimension; col++)
+			lastPrintedValues[row * dimension + col] = getCellValue(board, row, col);
+	hasPrintedBoard = true;
 }
 
 /**
@@ -72,11 +279,12 @@ void printBoard(Board* board) {
  * in the board.
  *
  * @param numCellsToFill	[in] the number of cells to fill, which is to be checked
- * @return true				iff numCellsToFill is appropriate (within the range [0, N*N - 1])
+ * @param numCells			[in] the total number of cells in the board
+ * @return true				iff numCellsToFill is appropriate (within the range [0, numCells - 1])
  * @return false			iff numCellsToFill is not appropriate
  */
-bool isNumCellsToFillValid(int numCellsToFill) {
-	return (numCellsToFill >= 0) && (numCellsToFill <= (N_SQUARE * N_SQUARE - 1));
+bool isNumCellsToFillValid(int numCellsToFill, int numCells) {
+	return (numCellsToFill >= 0) && (numCellsToFill <= (numCells - 1));
 }
 
 /**
@@ -85,25 +293,26 @@ bool isNumCellsToFillValid(int numCellsToFill) {
  * the user requested to fix is not in the appropriate range, an error message is printed out. If
  * the input the user provided is not an integer, the entire process is terminated.
  * 
+ * @param numCells				[in] the total number of cells in the board
  * @param numCellsToFillOut		[in, out] a pointer to an integer, assigned with the number of fixed
  * 								cells in the sudoku board initialized 
  * @return true					iff the user provided a valid number of cells to fix
- * @return false 				iff stdin reached EOF
+ * @return false 				iff the input reached EOF
  */
-bool getNumCellsToFill(int* numCellsToFillOut) {
+bool getNumCellsToFill(int numCells, int* numCellsToFillOut) {
 	while (true) {
 		int scanfRetVal = 0;
-		printf("Please enter the number of cells to fill [%d-%d]:\n", 0, N_SQUARE * N_SQUARE - 1);
-		scanfRetVal = scanf("%d", numCellsToFillOut);
-		if (feof(stdin) || (scanfRetVal == EOF)) {
+		printGameMessage("Please enter the number of cells to fill [%d-%d]:\n", 0, numCells - 1);
+		scanfRetVal = fscanf(getGameInput(), "%d", numCellsToFillOut);
+		if (feof(getGameInput()) || (scanfRetVal == EOF)) {
 			return false;
 		}
 		if (scanfRetVal == 1) {
-			if (isNumCellsToFillValid(*numCellsToFillOut)) {
+			if (isNumCellsToFillValid(*numCellsToFillOut, numCells)) {
 				return true;
 			}
 			else {
-				printf("Error: invalid number of cells to fill (should be between %d and %d)\n", 0, N_SQUARE * N_SQUARE - 1);
+				printf("Error: invalid number of cells to fill (should be between %d and %d)\n", 0, numCells - 1);
 			}
 		} else {
 			printf("Error: not a number\n");
@@ -118,47 +327,57 @@ bool getNumCellsToFill(int* numCellsToFillOut) {
  * initialStage initializes the state of the game when it begins. It takes a pointer to an 
  * at first null pointer, allocates it and writes the new sudoku board generated to that pointer.
  * Afterwards, the new sudoku board is printed to the user. 
+ * If unique generation is enabled, the fixed cells are chosen so that the puzzle has exactly one
+ * solution, in which case more cells than requested may end up fixed.
  * 
  * @param state		[in, out] a pointer to a null pointer, to be allocated and assigned by
  * 					initialStage 
  * @return true		iff the game has been successfully initialized 
  * @return false 	iff either getting the number of fixed board cells, puzzle generation
- * 					or game initialization has failed
+ * 					or game initialization has failed. If generation exhausted the search
+ * 					budget of the game, a timeout message is printed out
  */
 bool initialStage(State** state) {
-	Board board = {{{{0}}}};
+	Board* board = createBoard(gameBlockSize);
+	int dimension = getBoardDimension(board);
+	bool isInitialised = false;
 
 	int numFixedCells = 0;
-
-	if (!generatePuzzle(&board)) {
-		return false;
-	}
-
-	if (!getNumCellsToFill(&numFixedCells)) {
-		return false;
+	SolverStatus status = SOLVER_UNSOLVABLE;
+
+	hasGenerated = true;
+	status = generatePuzzle(board, &gameGenerator, &gameBudget, &lastGenerateStats);
+	if (status == SOLVER_GAVE_UP) {
+		printf("Generation timed out: gave up after %ld nodes\n", lastGenerateStats.numNodes);
+	} else if (status == SOLVER_SOLVED && getNumCellsToFill(dimension * dimension, &numFixedCells)) {
+		if (isUniqueGenerationEnabled) {
+			fixUniqueClues(board, numFixedCells, &gameGenerator);
+			isInitialised = initialiseWithFixedCells(state, board);
+		} else {
+			isInitialised = initialise(numFixedCells, state, board, &gameGenerator);
+		}
 	}
 
-	if (!initialise(numFixedCells, state, &board)) {
-		return false;
+	if (isInitialised) {
+		hasPrintedBoard = false;
+		printBoard(viewPuzzle(*state));
 	}
 
-	exportBoard(*state, &board);
-	printBoard(&board);
-
-	return true;
+	destroyBoard(board);
+	return isInitialised;
 }
 
 /**
- * getCommandString reads a command string from stdin, and writes the input
- * into the provided string pointer.
+ * getCommandString reads a command string from the input of the game (see getGameInput), and
+ * writes the input into the provided string pointer.
  * 
  * @param commandStrOut		[out] a pointer to a string. 
- * @param commandMaxSize	[in] the maximum input size in bytes that should be read stdin
+ * @param commandMaxSize	[in] the maximum input size in bytes that should be read
  * @return true 			iff a string was successfully fetched
  * @return false 			iff there had been an error and the input fetch had failed
  */
 bool getCommandString(char* commandStrOut, int commandMaxSize) {
-	char* fgetsRes = fgets(commandStrOut, commandMaxSize, stdin);
+	char* fgetsRes = fgets(commandStrOut, commandMaxSize, getGameInput());
 	return fgetsRes != NULL;
 }
 
@@ -184,12 +403,10 @@ void performSetCommand(State* state, SetCommandArguments* args) {
 			break;
 		}
 	} else {
-		Board board = {{{{0}}}};
-		exportBoard(state, &board);
-		printBoard(&board);
+		printBoard(viewPuzzle(state));
 
 		if (isGameWon(state)) {
-			printf("Puzzle solved successfully\n");
+			printGameMessage("Puzzle solved successfully\n");
 		}
 	}
 }
@@ -203,27 +420,104 @@ void performSetCommand(State* state, SetCommandArguments* args) {
  * @param args		[in] a pointer to the command arguments of the user's hint command
  */
 void performHintCommand(State* state, HintCommandArguments* args) {
-	printf("Hint: set cell to %d\n", hint(state, args->row - 1, args->col - 1));
+	printGameMessage("Hint: set cell to %d\n", hint(state, args->row - 1, args->col - 1));
 }
 
 /**
  * performValidateCommand executes a given 'validate' command from the user.
- * It uses the backtracking algorithm to solve the sudoku in its current state.
+ * The values the user has set are first checked against the stored solution: if they all agree
+ * with it, the game is known to be solvable and nothing is solved. Otherwise, the sudoku is
+ * solved incrementally in its current state: the cells away from the ones which deviate from
+ * the stored solution keep their stored values, and only the cells around the deviations are
+ * searched, with the currently selected engine, falling back to a search from scratch if that
+ * fails (see solvePuzzleIncrementally).
  * An appropriate message is presented to the user, indicating whether the game
  * can or cannot be solved in its current condition. 
  * 
+ * If the search exhausts the search budget of the game, a timeout message is presented
+ * instead, and the game is left as it is.
+ * 
  * Additionally, if the current game is found to be solvable, the solution produced
  * during the validation process is set to be the new solution of the game.
+ * The counters of the search are kept for the 'stats' command.
  * 
  * @param state		[in] current state of the game 
  */
 void performValidateCommand(State* state) {
-	Board solution = {{{{0}}}};
-	if (solvePuzzle(state, &solution)) {
-		printf("Validation passed: board is solvable\n");
-		setPuzzleSolution(state, &solution);
+	Board* solution = NULL;
+
+	hasValidated = true;
+	if (isGameConsistentWithSolution(state)) {
+		resetSolverStats(&lastValidateStats);
+		printGameMessage("Validation passed: board is solvable\n");
+		return;
+	}
+
+	solution = createBoard(getGameBlockSize(state));
+	switch (solvePuzzleIncrementally(state, solution, &gameBudget, &lastValidateStats)) {
+	case SOLVER_SOLVED:
+		printGameMessage("Validation passed: board is solvable\n");
+		setPuzzleSolution(state, solution);
+		break;
+	case SOLVER_GAVE_UP:
+		printf("Validation timed out: gave up after %ld nodes\n", lastValidateStats.numNodes);
+		break;
+	default:
+		printGameMessage("Validation failed: board is unsolvable\n");
+		break;
+	}
+	destroyBoard(solution);
+}
+
+/**
+ * printSolverStats prints the counters of a search on a single line.
+ *
+ * @param name		[in] the name of the operation the search was made for
+ * @param stats 	[in] the counters of the search
+ */
+void printSolverStats(char* name, SolverStats* stats) {
+	printGameMessage("%s: %ld nodes, %ld backtracks, %ld validity checks, max depth %d, %.6f seconds\n",
+		   name, stats->numNodes, stats->numBacktracks, stats->numValidityChecks,
+		   stats->maxDepth, stats->seconds);
+}
+
+/**
+ * performStatsCommand executes a given 'stats' command from the user. It prints the counters of
+ * the search made by the last 'validate' command (none, if the game agreed with its stored
+ * solution), and by the generation of the last game.
+ */
+void performStatsCommand() {
+	if (hasValidated) {
+		printSolverStats("Last validate", &lastValidateStats);
 	} else {
-		printf("Validation failed: board is unsolvable\n");
+		printGameMessage("Last validate: none\n");
+	}
+
+	if (hasGenerated) {
+		printSolverStats("Last generate", &lastGenerateStats);
+	} else {
+		printGameMessage("Last generate: none\n");
+	}
+}
+
+/**
+ * performUndoRedoCommand executes a given 'undo' or 'redo' command from the user. If there is
+ * no move to undo (or redo), an appropriate error message is displayed to the user. Otherwise,
+ * the updated sudoku board is printed, followed by a win message if a redone move has
+ * finished the game.
+ *
+ * @param state		[in, out] current state of the game
+ * @param isUndo 	[in] true for an 'undo' command, false for a 'redo' command
+ */
+void performUndoRedoCommand(State* state, bool isUndo) {
+	if (isUndo ? !undo(state) : !redo(state)) {
+		printf("Error: no moves to %s\n", isUndo ? "undo" : "redo");
+		return;
+	}
+
+	printBoard(viewPuzzle(state));
+	if (isGameWon(state)) {
+		printGameMessage("Puzzle solved successfully\n");
 	}
 }
 
@@ -242,10 +536,10 @@ void performValidateCommand(State* state) {
 void performCommand(State* state, Command* command, bool* shouldRestart, bool* shouldExit) {
 	switch (command->type) {
 	case SET:
-		performSetCommand(state, command->arguments);
+		performSetCommand(state, &(command->arguments.set));
 		break;
 	case HINT:
-		performHintCommand(state, command->arguments);
+		performHintCommand(state, &(command->arguments.hint));
 		break;
 	case VALIDATE:
 		performValidateCommand(state);
@@ -256,6 +550,15 @@ void performCommand(State* state, Command* command, bool* shouldRestart, bool* s
 	case EXIT:
 		*shouldExit = true;
 		break;
+	case STATS:
+		performStatsCommand();
+		break;
+	case UNDO:
+		performUndoRedoCommand(state, true);
+		break;
+	case REDO:
+		performUndoRedoCommand(state, false);
+		break;
 	case IGNORE:
 		break;
 	}
@@ -263,7 +566,8 @@ void performCommand(State* state, Command* command, bool* shouldRestart, bool* s
 
 /**
  * performCommandLoop manages the user interface of the game. It takes commands from the user and
- * validates them, displaying an error message when the command is found invalid. The commands are
+ * validates them (including the range of their arguments, according to the board's dimension),
+ * displaying an error message when the command is found invalid. The commands are
  * then performed and the game is updated accordingly. After each user turn it checks if the game
  * should be terminated, then it finishes.
  * 
@@ -271,25 +575,33 @@ void performCommand(State* state, Command* command, bool* shouldRestart, bool* s
  * @return true 	iff the game should be terminated
  */
 bool performCommandLoop(State* state) {
+	int dimension = getGameBlockSize(state) * getGameBlockSize(state);
 	bool shouldExit = false;
 	while (true) {
 		bool shouldRestart = false;
 		Command command = {0};
 		char commandStr[COMMAND_MAX_LENGTH + 1] = {0};
+		double startTime = 0;
 
 		if (!getCommandString(commandStr, COMMAND_MAX_LENGTH + 1)) {
 			shouldExit = true;
 			break;
 		}
 
-		if ((!parseCommand(commandStr, &command)) || (isGameWon(state) && command.type != RESTART && command.type != EXIT && command.type != IGNORE)){
+		if ((!parseCommand(commandStr, &command)) ||
+			(!areCommandArgumentsInRange(&command, dimension)) ||
+			(isGameWon(state) && command.type != RESTART && command.type != EXIT && command.type != STATS && command.type != IGNORE)){
 			printf("Error: invalid command\n");
+			replayCounters.numInvalid++;
+		} else if (isReplaying) {
+			startTime = getWallClockSeconds();
+			performCommand(state, &command, &shouldRestart, &shouldExit);
+			replayCounters.seconds[command.type] += getWallClockSeconds() - startTime;
+			replayCounters.numCommands[command.type]++;
 		} else {
 			performCommand(state, &command, &shouldRestart, &shouldExit);
 		}
 
-		cleanupCommand(&command);
-
 		if (shouldRestart || shouldExit) {
 			break;
 		}
@@ -309,6 +621,7 @@ bool runGame() {
 	State* state = NULL;
 
 	if (initialStage(&state)) {
+		replayCounters.numGames++;
 		shouldExit = performCommandLoop(state);
 		destruct(state);
 	} else {
@@ -316,7 +629,125 @@ bool runGame() {
 	}
 
 	if (shouldExit)
-		printf("Exiting...\n");
+		printGameMessage("Exiting...\n");
 
 	return shouldExit;
 }
+
+bool parseSolverEngine(char* name, SolverEngine* engineOut) {
+	if (strcmp(name, "backtracking") == 0) {
+		*engineOut = BACKTRACKING_ENGINE;
+	} else if (strcmp(name, "mrv") == 0) {
+		*engineOut = MRV_ENGINE;
+	} else if (strcmp(name, "dlx") == 0) {
+		*engineOut = DLX_ENGINE;
+	} else if (strcmp(name, "iterative") == 0) {
+		*engineOut = ITERATIVE_ENGINE;
+	} else if (strcmp(name, "parallel") == 0) {
+		*engineOut = PARALLEL_ENGINE;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+bool parseBoardOutputMode(char* name, BoardOutputMode* modeOut) {
+	if (strcmp(name, "grid") == 0) {
+		*modeOut = BOARD_OUTPUT_GRID;
+	} else if (strcmp(name, "compact") == 0) {
+		*modeOut = BOARD_OUTPUT_COMPACT;
+	} else if (strcmp(name, "diff") == 0) {
+		*modeOut = BOARD_OUTPUT_DIFF;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+void setBoardOutputMode(BoardOutputMode mode) {
+	boardOutputMode = mode;
+}
+
+void setUniquePuzzleGeneration(bool isEnabled) {
+	isUniqueGenerationEnabled = isEnabled;
+}
+
+bool setGameBlockSize(int blockSize) {
+	if (blockSize < MIN_BLOCK_SIZE || blockSize > MAX_BLOCK_SIZE) {
+		return false;
+	}
+	gameBlockSize = blockSize;
+	return true;
+}
+
+void setGameSeed(unsigned long seed) {
+	seedRandomGenerator(&gameGenerator, seed, 0);
+}
+
+void setGameSearchBudget(long maxNodes, double maxSeconds) {
+	gameBudget.maxNodes = maxNodes;
+	gameBudget.maxSeconds = maxSeconds;
+}
+
+/**
+ * printReplaySummary prints the counters of a replayed script, and its throughput, to stderr.
+ *
+ * @param seconds 		[in] the duration of the replay, in seconds
+ */
+void printReplaySummary(double seconds) {
+	const char* commandNames[NUM_COMMAND_TYPES] = {"set", "hint", "validate", "restart", "exit", "stats", "undo", "redo", "empty"};
+	long numCommands = replayCounters.numInvalid;
+	int type = 0;
+
+	for (type = 0; type < NUM_COMMAND_TYPES; type++) {
+		numCommands += replayCounters.numCommands[type];
+	}
+
+	fprintf(stderr, "Replay: %ld commands, %ld games, %.3f seconds, %.0f commands/sec\n",
+			numCommands, replayCounters.numGames, seconds, (seconds > 0) ? numCommands / seconds : 0.0);
+	for (type = 0; type < NUM_COMMAND_TYPES; type++) {
+		long count = replayCounters.numCommands[type];
+		if (count > 0) {
+			fprintf(stderr, "  %s: %ld commands, %.6f seconds, %.3f us/command\n", commandNames[type], count,
+					replayCounters.seconds[type], 1e6 * replayCounters.seconds[type] / count);
+		}
+	}
+	if (replayCounters.numInvalid > 0) {
+		fprintf(stderr, "  invalid: %ld commands\n", replayCounters.numInvalid);
+	}
+}
+
+bool runReplay(char* scriptPath) {
+	double startTime = getWallClockSeconds();
+	char* buffer = NULL;
+	bool shouldExit = false;
+
+	gameInput = fopen(scriptPath, "r");
+	if (gameInput == NULL) {
+		fprintf(stderr, "Error: could not open %s\n", scriptPath);
+		return false;
+	}
+
+	/* the script is read in large blocks, unlike stdin (see SP_BUFF_SET) */
+	buffer = malloc(REPLAY_BUFFER_SIZE);
+	if (buffer == NULL) {
+		/* NOTE: for now we are allowed this behaviour: */
+		printf("Error: runReplay has failed\n");
+		exit(EXIT_FAILURE);
+	}
+	setvbuf(gameInput, buffer, _IOFBF, REPLAY_BUFFER_SIZE);
+
+	memset(&replayCounters, 0, sizeof(ReplayCounters));
+	isReplaying = true;
+	while (!shouldExit) {
+		shouldExit = runGame();
+	}
+	isReplaying = false;
+
+	fclose(gameInput);
+	gameInput = NULL;
+	free(buffer);
+
+	printReplaySummary(getWallClockSeconds() - startTime);
+	return true;
+}
@@ -4,19 +4,157 @@
  * A module designed to help main run a proper sudoku game
  *
  * runGame - runs a sudoku game
+ * runReplay - runs the games of a recorded command script, printing only errors and a summary
+ * parseSolverEngine - translates a solver engine name given on the command line
+ * parseBoardOutputMode - translates a board output mode name given on the command line
+ * setBoardOutputMode - selects the format boards are printed in
+ * setUniquePuzzleGeneration - selects whether new games must have a unique solution
+ * setGameBlockSize - selects the board size of new games
+ * setGameSeed - seeds the random generator of new games
+ * setGameSearchBudget - limits the searches made for generating and validating games
  */
 
 #ifndef MAIN_AUX_H_
 #define MAIN_AUX_H_
 
+#include <stdarg.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 #include "game.h"
 #include "parser.h"
+#include "puzzle_io.h"
 #include "solver.h"
+#include "timing.h"
+
+/**
+ * The default wall clock time, in seconds, a search made by the game may run for before it is
+ * given up (see setGameSearchBudget).
+ */
+#define DEFAULT_GAME_SEARCH_SECONDS (10.0)
+
+/**
+ * BoardOutputMode enumerates the formats the game prints its board in:
+ * BOARD_OUTPUT_GRID		- the full grid, with separators and fixed cells marked (the default)
+ * BOARD_OUTPUT_COMPACT		- a single line of one character per cell (see formatBoard), for
+ * 							  scripts
+ * BOARD_OUTPUT_DIFF		- a line "row column value" per cell changed since the board was
+ * 							  last printed (the whole board as in compact mode at first), for
+ * 							  scripts
+ */
+typedef enum boardOutputMode {
+	BOARD_OUTPUT_GRID,
+	BOARD_OUTPUT_COMPACT,
+	BOARD_OUTPUT_DIFF} BoardOutputMode;
+
+/**
+ * The number of command types (see CommandType), IGNORE included.
+ */
+#define NUM_COMMAND_TYPES (IGNORE + 1)
+
+/**
+ * The size of the input buffer a script is replayed through, in bytes.
+ */
+#define REPLAY_BUFFER_SIZE (1 << 20)
+
+/**
+ * ReplayCounters struct keeps the counters of a replayed script: the number of games played,
+ * the number of commands performed of each type, and the wall clock time they took, and the
+ * number of invalid commands.
+ */
+typedef struct {
+	long numGames;
+	long numCommands[NUM_COMMAND_TYPES];
+	double seconds[NUM_COMMAND_TYPES];
+	long numInvalid;
+} ReplayCounters;
 
 bool runGame();
 
+/**
+ * runReplay runs the games of a recorded command script, as if it were typed in: each game
+ * starts with the number of cells to fill, followed by commands, and 'restart' starts the next
+ * game. The script is read through a large buffer, and only errors are printed (no prompts,
+ * boards or command results). Once the script ends, or 'exit' is read, a summary is printed to
+ * stderr: the number of commands and games, the throughput, and the count and time of each
+ * type of command.
+ * If the buffer could not be allocated, an error message is printed out and the process is
+ * terminated.
+ *
+ * @param scriptPath 	[in] the path of the script
+ * @return true 		iff the script was replayed
+ * @return false 		iff the script could not be opened
+ */
+bool runReplay(char* scriptPath);
+
+/**
+ * parseSolverEngine translates the name of a solver engine, as provided by the user on the
+ * command line, to the matching SolverEngine value.
+ *
+ * @param name			[in] the engine name: "backtracking", "mrv", "dlx", "iterative" or
+ * 						"parallel"
+ * @param engineOut 	[out] a pointer to a SolverEngine, to be assigned with the engine
+ * @return true 		iff name matches one of the engines
+ * @return false 		iff name is not a known engine name
+ */
+bool parseSolverEngine(char* name, SolverEngine* engineOut);
+
+/**
+ * parseBoardOutputMode translates the name of a board output mode, as provided by the user on
+ * the command line, to the matching BoardOutputMode value.
+ *
+ * @param name			[in] the mode name: "grid", "compact" or "diff"
+ * @param modeOut 		[out] a pointer to a BoardOutputMode, to be assigned with the mode
+ * @return true 		iff name matches one of the modes
+ * @return false 		iff name is not a known mode name
+ */
+bool parseBoardOutputMode(char* name, BoardOutputMode* modeOut);
+
+/**
+ * setBoardOutputMode selects the format the game prints its board in (see BoardOutputMode).
+ * The default mode is BOARD_OUTPUT_GRID.
+ *
+ * @param mode		[in] the board output mode
+ */
+void setBoardOutputMode(BoardOutputMode mode);
+
+/**
+ * setUniquePuzzleGeneration selects how the fixed cells of new games are chosen. When
+ * enabled, clues are only removed from the generated board as long as the puzzle keeps
+ * exactly one solution (see fixUniqueClues), so hints always agree with any valid fill.
+ * Otherwise, the fixed cells are chosen at random. Disabled by default.
+ *
+ * @param isEnabled		[in] whether new games must have a unique solution
+ */
+void setUniquePuzzleGeneration(bool isEnabled);
+
+/**
+ * setGameBlockSize selects the size of the boards of new games: a block size of n makes for
+ * a board of n*n rows and columns. The default block size is DEFAULT_BLOCK_SIZE.
+ *
+ * @param blockSize		[in] the block size of new games
+ * @return true 		iff blockSize is within the range [MIN_BLOCK_SIZE, MAX_BLOCK_SIZE]
+ * @return false 		iff blockSize is out of range, in which case it is ignored
+ */
+bool setGameBlockSize(int blockSize);
+
+/**
+ * setGameSeed seeds the random generator used to generate new games, so that a session can be
+ * reproduced from its seed.
+ *
+ * @param seed		[in] the seed
+ */
+void setGameSeed(unsigned long seed);
+
+/**
+ * setGameSearchBudget limits the searches made by the game, for generating a new game and for
+ * the 'validate' command, so that the command loop reports a timeout instead of hanging on a
+ * hard board. By default, searches are limited to DEFAULT_GAME_SEARCH_SECONDS seconds.
+ *
+ * @param maxNodes		[in] the number of nodes a search may visit, or 0 for no limit
+ * @param maxSeconds 	[in] the wall clock time a search may run for, or 0 for no limit
+ */
+void setGameSearchBudget(long maxNodes, double maxSeconds);
+
 #endif /* MAIN_AUX_H_ */
@@ -0,0 +1,309 @@
+#include "parallel.h"
+
+/**
+ * TaskDeque struct represents the deque of tasks of one thread, as the range [front, back) of
+ * an array of task indices, kept in ascending order. Its owner takes tasks from the front,
+ * thieves take them from the back. All fields are protected by mutex.
+ */
+typedef struct {
+	pthread_mutex_t mutex;
+	int* taskIndices;
+	int front;
+	int back;
+} TaskDeque;
+
+/**
+ * ParallelSearch struct holds the state shared by the threads of a parallel search. Tasks are
+ * numbered in the order the serial search would visit their subtrees. solutionTaskIndex is the
+ * lowest index of a task which found a solution so far, or numTasks if none did. numNodes
+ * counts the nodes visited by all the threads, and hasGivenUp is set once it or the clock
+ * exceeds the budget (maxNodes and deadline, as in SolverStats). solutionTaskIndex, solution,
+ * numNodes and hasGivenUp are protected by resultMutex.
+ */
+typedef struct {
+	SolverContext** tasks;
+	int numTasks;
+	TaskDeque* deques;
+	int numThreads;
+	bool isDeterministic;
+	long maxNodes;
+	double deadline;
+	pthread_mutex_t resultMutex;
+	int solutionTaskIndex;
+	Board* solution;
+	long numNodes;
+	bool hasGivenUp;
+} ParallelSearch;
+
+/**
+ * ParallelWorker struct is the argument of a thread of a parallel search.
+ */
+typedef struct {
+	ParallelSearch* search;
+	int threadIndex;
+} ParallelWorker;
+
+/**
+ * splitSearchTree splits the search over a board into tasks, expanding the search tree level
+ * by level, left to right, until there are enough tasks for the threads to share, or the
+ * maximal split depth is reached. Nodes which cannot be split are kept as they are, so the
+ * tasks returned cover the whole tree, in the order the serial search would visit them.
+ *
+ * @param board				[in] the board to be solved
+ * @param numThreads 		[in] the number of threads the tasks will be run on
+ * @param numTasksOut 		[out] the number of tasks created
+ * @return SolverContext**	the array of tasks, to be freed along with every task
+ */
+SolverContext** splitSearchTree(Board* board, int numThreads, int* numTasksOut) {
+	int targetNumTasks = numThreads * PARALLEL_TASKS_PER_THREAD;
+	/* a single split, made while below the target, adds fewer than dimension tasks */
+	int capacity = targetNumTasks + getBoardDimension(board);
+	SolverContext** frontier = calloc(capacity, sizeof(SolverContext*));
+	SolverContext** nextFrontier = calloc(capacity, sizeof(SolverContext*));
+	int numTasks = 1, depth = 0;
+	bool hasSplit = true;
+
+	exitOnFailure(frontier == NULL || nextFrontier == NULL, "solveBoardParallel");
+	frontier[0] = createSolverContext(board, NULL);
+
+	for (depth = 0; depth < PARALLEL_MAX_SPLIT_DEPTH && hasSplit && numTasks < targetNumTasks; depth++) {
+		SolverContext** temp = NULL;
+		int numNextTasks = 0, i = 0;
+		hasSplit = false;
+
+		for (i = 0; i < numTasks; i++) {
+			int numChildren = 0;
+			if (numNextTasks + (numTasks - i) < targetNumTasks) {
+				numChildren = splitSolverContext(frontier[i], nextFrontier + numNextTasks);
+			}
+
+			if (numChildren == 0) {
+				nextFrontier[numNextTasks++] = frontier[i];
+			} else {
+				destroySolverContext(frontier[i]);
+				numNextTasks += numChildren;
+				hasSplit = true;
+			}
+		}
+
+		temp = frontier;
+		frontier = nextFrontier;
+		nextFrontier = temp;
+		numTasks = numNextTasks;
+	}
+
+	free(nextFrontier);
+	*numTasksOut = numTasks;
+	return frontier;
+}
+
+/**
+ * isTaskCancelled checks whether a task no longer needs to be run: once the budget of the
+ * search is exhausted, in deterministic mode once a task preceding it has found a solution,
+ * and otherwise once any task has.
+ *
+ * @param search		[in] the parallel search
+ * @param taskIndex 	[in] the index of the task
+ * @return true 		iff the task should be stopped
+ * @return false 		iff the task should go on
+ */
+bool isTaskCancelled(ParallelSearch* search, int taskIndex) {
+	bool isCancelled = false;
+
+	pthread_mutex_lock(&(search->resultMutex));
+	if (search->hasGivenUp) {
+		isCancelled = true;
+	} else if (search->isDeterministic) {
+		isCancelled = search->solutionTaskIndex < taskIndex;
+	} else {
+		isCancelled = search->solutionTaskIndex < search->numTasks;
+	}
+	pthread_mutex_unlock(&(search->resultMutex));
+
+	return isCancelled;
+}
+
+/**
+ * takeTask takes the next task for a thread: the first task of its own deque, or if it is
+ * empty, the last task of another thread's deque.
+ *
+ * @param search		[in, out] the parallel search
+ * @param threadIndex 	[in] the index of the calling thread
+ * @return int			the index of the task taken, or -1 if all deques are empty
+ */
+int takeTask(ParallelSearch* search, int threadIndex) {
+	int i = 0;
+
+	for (i = 0; i < search->numThreads; i++) {
+		TaskDeque* deque = &(search->deques[(threadIndex + i) % search->numThreads]);
+		int taskIndex = -1;
+
+		pthread_mutex_lock(&(deque->mutex));
+		if (deque->front < deque->back) {
+			if (i == 0) {
+				taskIndex = deque->taskIndices[deque->front++];
+			} else {
+				taskIndex = deque->taskIndices[--deque->back];
+			}
+		}
+		pthread_mutex_unlock(&(deque->mutex));
+
+		if (taskIndex >= 0) {
+			return taskIndex;
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * chargeParallelBudget adds the nodes a task visited in its last slice to the count of the
+ * search, and gives the search up if its budget is exhausted.
+ *
+ * @param search		[in, out] the parallel search
+ * @param task 			[in] the task which has just run a slice
+ * @param numNodesInOut [in, out] the number of nodes of the task charged so far, updated
+ */
+void chargeParallelBudget(ParallelSearch* search, SolverContext* task, long* numNodesInOut) {
+	SolverStats taskStats;
+
+	resetSolverStats(&taskStats);
+	addSolverContextStats(task, &taskStats);
+
+	pthread_mutex_lock(&(search->resultMutex));
+	search->numNodes += taskStats.numNodes - *numNodesInOut;
+	if ((search->maxNodes > 0 && search->numNodes >= search->maxNodes) ||
+		(search->deadline > 0 && getWallClockSeconds() >= search->deadline)) {
+		search->hasGivenUp = true;
+	}
+	pthread_mutex_unlock(&(search->resultMutex));
+
+	*numNodesInOut = taskStats.numNodes;
+}
+
+/**
+ * runTask runs a task in slices until it finishes or is cancelled, and records its solution
+ * if it found one preceding all those found so far.
+ *
+ * @param search		[in, out] the parallel search
+ * @param taskIndex 	[in] the index of the task
+ */
+void runTask(ParallelSearch* search, int taskIndex) {
+	SolverContext* task = search->tasks[taskIndex];
+	SolverStatus status = SOLVER_RUNNING;
+	long numNodesCharged = 0;
+
+	while (status == SOLVER_RUNNING && !isTaskCancelled(search, taskIndex)) {
+		status = solverStep(task, PARALLEL_NODES_PER_SLICE);
+		chargeParallelBudget(search, task, &numNodesCharged);
+	}
+
+	if (status == SOLVER_SOLVED) {
+		pthread_mutex_lock(&(search->resultMutex));
+		if (taskIndex < search->solutionTaskIndex) {
+			search->solutionTaskIndex = taskIndex;
+			exportSolverBoard(task, search->solution);
+		}
+		pthread_mutex_unlock(&(search->resultMutex));
+	}
+}
+
+/**
+ * runParallelWorker is the main function of the threads of a parallel search. It runs tasks
+ * until none is left in any deque.
+ *
+ * @param argument	[in] a pointer to the thread's ParallelWorker
+ * @return void*	NULL
+ */
+void* runParallelWorker(void* argument) {
+	ParallelWorker* worker = (ParallelWorker*)argument;
+	int taskIndex = 0;
+
+	while ((taskIndex = takeTask(worker->search, worker->threadIndex)) >= 0) {
+		runTask(worker->search, taskIndex);
+	}
+
+	return NULL;
+}
+
+bool solveBoardParallel(Board* board, int numThreads, bool isDeterministic, SolverStats* statsInOut) {
+	ParallelSearch search;
+	ParallelWorker* workers = NULL;
+	pthread_t* threads = NULL;
+	int* taskIndices = NULL;
+	bool isSolved = false;
+	int i = 0, numDealt = 0;
+
+	if (numThreads < 1) {
+		numThreads = 1;
+	}
+
+	search.tasks = splitSearchTree(board, numThreads, &(search.numTasks));
+	search.numThreads = numThreads;
+	search.isDeterministic = isDeterministic;
+	search.maxNodes = statsInOut->maxNodes;
+	search.deadline = statsInOut->deadline;
+	search.solutionTaskIndex = search.numTasks;
+	search.solution = createBoard(getBlockSize(board));
+	search.numNodes = statsInOut->numNodes;
+	search.hasGivenUp = false;
+
+	search.deques = calloc(numThreads, sizeof(TaskDeque));
+	taskIndices = calloc(search.numTasks, sizeof(int));
+	workers = calloc(numThreads, sizeof(ParallelWorker));
+	threads = calloc(numThreads, sizeof(pthread_t));
+	exitOnFailure(search.deques == NULL || taskIndices == NULL || workers == NULL || threads == NULL, "solveBoardParallel");
+	exitOnFailure(pthread_mutex_init(&(search.resultMutex), NULL) != 0, "solveBoardParallel");
+
+	/* deal the tasks out in turn, so every thread starts with some of the earliest ones */
+	for (i = 0; i < numThreads; i++) {
+		TaskDeque* deque = &(search.deques[i]);
+		int taskIndex = 0;
+
+		exitOnFailure(pthread_mutex_init(&(deque->mutex), NULL) != 0, "solveBoardParallel");
+		deque->taskIndices = taskIndices + numDealt;
+		deque->front = 0;
+		deque->back = 0;
+		for (taskIndex = i; taskIndex < search.numTasks; taskIndex += numThreads) {
+			deque->taskIndices[deque->back++] = taskIndex;
+		}
+		numDealt += deque->back;
+
+		workers[i].search = &search;
+		workers[i].threadIndex = i;
+	}
+
+	/* the calling thread is the first worker */
+	for (i = 1; i < numThreads; i++) {
+		exitOnFailure(pthread_create(&(threads[i]), NULL, runParallelWorker, &(workers[i])) != 0, "solveBoardParallel");
+	}
+	runParallelWorker(&(workers[0]));
+	for (i = 1; i < numThreads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	/* once given up, the tasks preceding the solution found may not have finished */
+	isSolved = search.solutionTaskIndex < search.numTasks && !(isDeterministic && search.hasGivenUp);
+	if (isSolved) {
+		copyBoard(board, search.solution);
+	}
+
+	for (i = 0; i < numThreads; i++) {
+		pthread_mutex_destroy(&(search.deques[i].mutex));
+	}
+	pthread_mutex_destroy(&(search.resultMutex));
+	for (i = 0; i < search.numTasks; i++) {
+		addSolverContextStats(search.tasks[i], statsInOut);
+		destroySolverContext(search.tasks[i]);
+	}
+	if (!isSolved && search.hasGivenUp) {
+		statsInOut->hasGivenUp = true;
+	}
+	destroyBoard(search.solution);
+	free(search.tasks);
+	free(search.deques);
+	free(taskIndices);
+	free(workers);
+	free(threads);
+	return isSolved;
+}
@@ -0,0 +1,63 @@
+/**
+ * PARALLEL Summary:
+ *
+ * A module designed to solve a single sudoku board on several threads. The search tree is
+ * split at a shallow depth into tasks (see splitSolverContext), which are spread over one
+ * deque per thread. Each thread takes tasks from the front of its own deque, and steals from
+ * the back of the others' once its own is empty. Tasks are run in bounded slices (see
+ * solverStep), between which the threads check whether the search has been cancelled.
+ *
+ * solveBoardParallel - solves a sudoku board in place on several threads
+ */
+
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "game.h"
+#include "solver.h"
+#include "workpool.h"
+
+/**
+ * The number of tasks the search tree is split into, per thread, so that threads which
+ * finish their tasks early have some left to steal.
+ */
+#define PARALLEL_TASKS_PER_THREAD (16)
+
+/**
+ * The maximal depth at which the search tree is split.
+ */
+#define PARALLEL_MAX_SPLIT_DEPTH (8)
+
+/**
+ * The number of nodes a thread visits between two checks for cancellation.
+ */
+#define PARALLEL_NODES_PER_SLICE (4096)
+
+/**
+ * solveBoardParallel solves a given sudoku board in place, on several threads. The search
+ * branches on the empty cell with the fewest candidates, as MRV_ENGINE does. Its budget is
+ * checked between slices, so it may be exceeded by up to a slice per thread.
+ * If resources could not be allocated, an error message is printed out and the process is
+ * terminated.
+ *
+ * @param board				[in, out] a pointer to the Board struct to be solved. If solving
+ * 							succeeds, its empty cells are filled with a solution; otherwise the
+ * 							board is left unchanged
+ * @param numThreads 		[in] the number of threads to search on
+ * @param isDeterministic 	[in] if false, all threads stop as soon as any of them finds a
+ * 							solution, which is then used; if true, the solution used is the one
+ * 							MRV_ENGINE would have found, which may take longer
+ * @param statsInOut 		[in, out] the counters the work of all the threads is added to. Their
+ * 							budget applies to the search as a whole
+ * @return true 			iff the board was successfully solved
+ * @return false 			iff the board has no solution, or the budget was exhausted first (see
+ * 							hasGivenUp)
+ */
+bool solveBoardParallel(Board* board, int numThreads, bool isDeterministic, SolverStats* statsInOut);
+
+#endif /* PARALLEL_H_ */
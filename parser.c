@@ -1,59 +1,68 @@
 #include "parser.h"
 
-#define UNUSED(x) (void)(x)
-
 #define COMMAND_DELIMITERS " \t\r\n"
 
+/**
+ * Integer arguments stop growing once they reach this limit, which is beyond the range of any
+ * argument, so that long strings of digits cannot overflow.
+ */
+#define COMMAND_INT_ARG_LIMIT (1000000)
+
 /* function pointer to a concrete command type's ArgParser. There currently are 2 of these:
 * setArgsParser and hintArgsParser.	
-* @params arg			[in] the string containing the specific argument currently
- * 						being parsed
-* @params argState 		[in, out] a pointer to the concrete command argument struct
+* @params arg			[in] the token containing the specific argument currently
+ * 						being parsed (not terminated)
+* @params length		[in] the length of the token
+* @params arguments 	[in, out] a pointer to the Command whose arguments are parsed
 * @params argNo		 	[in] the parsed argument's index
 */
-typedef bool (*commandArgsParser)(char* arg, void* argsState, int argNo);
-
-/* 
-* Reserved for future use. 
-*
-* function pointer to a concrete implementation of a command cleaner of a specific
-* command type.
-* 
-* @params argState	a generic pointer to the concrete command argument struct
-* 
-*
-*/
-typedef void (*commandArgsCleaner)(void* argsState);
+typedef bool (*commandArgsParser)(const char* arg, int length, Command* command, int argNo);
 
 /**
- * parseIntArg parses a string representing an integer into an integer, then
+ * CommandSpec struct describes a command of the game: its name, its type, the number of
+ * arguments it takes, and the parser of its arguments (NULL if it takes none).
+ */
+typedef struct {
+	const char* name;
+	CommandType type;
+	int argsNum;
+	commandArgsParser parser;
+} CommandSpec;
+
+/**
+ * parseIntArg parses a token representing an integer into an integer, then
  * assigns it to the provided integer pointer. 
  * 
- * @param arg		[in] the string to be parsed 
+ * @param arg		[in] the token to be parsed 
+ * @param length	[in] the length of the token
  * @param dst 		[in, out] a pointer to an integer to be assigned with
  * 					the parse result
  * @return true		iff parsing was successful 
  * @return false 	iff provided input was not entirely composed of digits
  */
-bool parseIntArg(char* arg, int* dst) {
-	char* p;
+bool parseIntArg(const char* arg, int length, int* dst) {
+	int value = 0;
+	int i = 0;
 
 	/* validate that arg is all digits */
-	for (p = arg; *p != '\0'; p++)
-		if (*p < '0' || '9' < *p)
+	for (i = 0; i < length; i++) {
+		if (arg[i] < '0' || '9' < arg[i])
 			return false;
+		if (value < COMMAND_INT_ARG_LIMIT)
+			value = value * 10 + (arg[i] - '0');
+	}
 
-	*dst = atoi(arg);
+	*dst = value;
 	return true;
 }
 
 /**
  * setArgsParser concretely implements an argument parser for the 'set' command. 
  * 
- * @param arg			[in] the string containing the specific argument currently
+ * @param arg			[in] the token containing the specific argument currently
  * 						being parsed and assigned to the appropriate attribute 
- * @param argsState		[in, out] a generic pointer to a command argument struct, casted
- * 						to be a SetCommandArgument struct containing the arguments	 
+ * @param length		[in] the length of the token
+ * @param command		[in, out] the Command whose set arguments are assigned
  * @param argNo 		[in] the parsed argument's index: argument 1 is the number of
  * 						column of the cell for which the user requested a hint, argument 
  * 						2 is the number of the row, and argument 3 is the value to be set
@@ -61,15 +70,15 @@ bool parseIntArg(char* arg, int* dst) {
  * @return true 		iff parseIntArg successfully parsed and set a valid integer
  * @return false 		iff the parsing failed
  */
-bool setArgsParser(char* arg, void* argsState, int argNo) {
-	SetCommandArguments* setArgsState = (SetCommandArguments*)argsState;
+bool setArgsParser(const char* arg, int length, Command* command, int argNo) {
+	SetCommandArguments* setArgs = &(command->arguments.set);
 	switch (argNo) {
 	case 1:
-		return parseIntArg(arg, &(setArgsState->col));
+		return parseIntArg(arg, length, &(setArgs->col));
 	case 2:
-		return parseIntArg(arg, &(setArgsState->row));
+		return parseIntArg(arg, length, &(setArgs->row));
 	case 3:
-		return parseIntArg(arg, &(setArgsState->value));
+		return parseIntArg(arg, length, &(setArgs->value));
 	}
 	return false;
 }
@@ -77,123 +86,157 @@ bool setArgsParser(char* arg, void* argsState, int argNo) {
 /**
  * hintArgsParser concretely implements an argument parser for the 'hint' command. 
  * 
- * @param arg	 		[in] the string containing the specific argument currently
+ * @param arg	 		[in] the token containing the specific argument currently
  * 						being parsed and assigned to the appropriate attribute
- * @param argsState		[in, out] a generic pointer to a command argument struct, casted
- * 						to be a HintCommandArgument struct containing the arguments	
+ * @param length		[in] the length of the token
+ * @param command		[in, out] the Command whose hint arguments are assigned
  * @param argNo 		[in] the parsed argument's index: argument 1 is the number of
  * 						column of the cell for which the user requested a hint, and
  * 						argument 2 is the number of the row
  * @return true			iff parseIntArg successfully parsed and set a valid integer 		
  * @return false 		iff the parsing failed
  */
-bool hintArgsParser(char* arg, void* argsState, int argNo) {
-	HintCommandArguments* hintArgsState = (HintCommandArguments*)argsState;
+bool hintArgsParser(const char* arg, int length, Command* command, int argNo) {
+	HintCommandArguments* hintArgs = &(command->arguments.hint);
 	switch (argNo) {
 	case 1:
-		return parseIntArg(arg, &(hintArgsState->col));
+		return parseIntArg(arg, length, &(hintArgs->col));
 	case 2:
-		return parseIntArg(arg, &(hintArgsState->row));
+		return parseIntArg(arg, length, &(hintArgs->row));
 	}
 	return false;
 }
 
 /**
- * Called by parseCommand, parseArgs continutes processing the user input strings to finish 
- * the initialization of the Command struct, started by the caller. parseArgs provides
- * an appropriate parser for the type of command currently being processed. parseArgs uses the
- * parser to create a struct of the command's arguments according to its type. 
- * 
- * @param argsStr				[in] the user input string containing the command arguments 
- * @param argumentsStruct 		[in, out] a generic pointer to be assigned the command struct
- * 								with appropriate arguments after parsing is finished
- * @param argsNum 				[in] the expected number of command arguments according to 
- * 								the command type
- * @param parser				[in] the appropriate parser for the given type of command 
- * @return true 				iff the user provided a sufficient number of valid arguments
- * @return false 				iff the user provided an insufficient number of arguments, 
- * 								too many arguments, or invalid arguments values.
+ * findCommandSpec finds the command named by a token. The first character of the token
+ * selects the single command it may name, so the name is compared only once.
+ *
+ * @param name				[in] the token (not terminated)
+ * @param length 			[in] the length of the token
+ * @return const CommandSpec*	the command named, or NULL if the token names no command
  */
-bool parseArgs(char* argsStr, void* argumentsStruct, int argsNum, commandArgsParser parser) {
-	char* arg = NULL;
-	int i = 0;
-
-	UNUSED(argsStr); /* It seems bizarre not to have this parameter, so we keep it even 
-	if it isn't used explicitly (it's used implicitly by strtok) */
-
-	for (i = 0; i < argsNum; i++) {
-		arg = strtok(NULL, COMMAND_DELIMITERS);
-		if (arg == NULL) {
-			/* no remaining tokens in input can happen if expected arg count isn't reached */
-			return false;
-		}
-		if (! parser(arg, argumentsStruct, i + 1)) {
-			return false;
-		}
+const CommandSpec* findCommandSpec(const char* name, int length) {
+	static const CommandSpec specs[] = {
+		{"set", SET, SET_COMMAND_ARGS_NUM, setArgsParser},
+		{"hint", HINT, HINT_COMMAND_ARGS_NUM, hintArgsParser},
+		{"validate", VALIDATE, VALIDATE_COMMAND_ARGS_NUM, NULL},
+		{"restart", RESTART, RESTART_COMMAND_ARGS_NUM, NULL},
+		{"exit", EXIT, EXIT_COMMAND_ARGS_NUM, NULL},
+		{"stats", STATS, STATS_COMMAND_ARGS_NUM, NULL},
+		{"undo", UNDO, UNDO_COMMAND_ARGS_NUM, NULL},
+		{"redo", REDO, REDO_COMMAND_ARGS_NUM, NULL}};
+	const CommandSpec* spec = NULL;
+
+	switch (name[0]) {
+	case 's':
+		/* 'set' and 'stats' differ in length */
+		spec = (length == 3) ? &(specs[0]) : &(specs[5]);
+		break;
+	case 'h':
+		spec = &(specs[1]);
+		break;
+	case 'v':
+		spec = &(specs[2]);
+		break;
+	case 'r':
+		/* 'restart' and 'redo' differ in length */
+		spec = (length == 4) ? &(specs[7]) : &(specs[3]);
+		break;
+	case 'u':
+		spec = &(specs[6]);
+		break;
+	case 'e':
+		spec = &(specs[4]);
+		break;
+	default:
+		return NULL;
 	}
 
-	return true;
+	if ((int)strlen(spec->name) != length || memcmp(spec->name, name, length) != 0) {
+		return NULL;
+	}
+	return spec;
 }
 
-void cleanupCommand(Command* command) {
-	commandArgsCleaner cleaners[] = {NULL, NULL, NULL, NULL, NULL, NULL}; /* No cleanup is necessary for any command yet */
+const char* nextCommandToken(const char** cursorInOut, int* lengthOut) {
+	const char* token = *cursorInOut + strspn(*cursorInOut, COMMAND_DELIMITERS);
 
-	if (command == NULL || command->arguments == NULL) {
-		return;
+	if (*token == '\0') {
+		*cursorInOut = token;
+		return NULL;
 	}
 
-	if (cleaners[command->type] != NULL) {
-		cleaners[command->type](command->arguments);
-	}
-
-	free(command->arguments);
+	*lengthOut = (int)strcspn(token, COMMAND_DELIMITERS);
+	*cursorInOut = token + *lengthOut;
+	return token;
 }
 
-bool parseCommand(char* commandStr, Command* commandOut) {
-	int argsNum = 0;
-	commandArgsParser parser = NULL;
+bool parseCommand(const char* commandStr, Command* commandOut) {
+	const char* cursor = commandStr;
+	const CommandSpec* spec = NULL;
+	const char* token = NULL;
+	int length = 0;
+	int i = 0;
 
-	char* type = strtok(commandStr, COMMAND_DELIMITERS);
-	if (type == NULL) {
+	token = nextCommandToken(&cursor, &length);
+	if (token == NULL) {
 		commandOut->type = IGNORE;
 		return true;
-	} else if (strcmp(type, "set") == 0) {
-		commandOut->type = SET;
-		commandOut->arguments = calloc(1, sizeof(SetCommandArguments));
-		argsNum = SET_COMMAND_ARGS_NUM;
-		parser = &setArgsParser;
-	} else if (strcmp(type, "hint") == 0) {
-		commandOut->type = HINT;
-		commandOut->arguments = calloc(1, sizeof(HintCommandArguments));
-		argsNum = HINT_COMMAND_ARGS_NUM;
-		parser = &hintArgsParser;
-	} else if (strcmp(type, "validate") == 0) {
-		commandOut->type = VALIDATE;
-		commandOut->arguments = calloc(1, sizeof(ValidateCommandArguments));
-		argsNum = VALIDATE_COMMAND_ARGS_NUM;
-	} else if (strcmp(type, "restart") == 0) {
-		commandOut->type = RESTART;
-		commandOut->arguments = calloc(1, sizeof(RestartCommandArguments));
-		argsNum = RESTART_COMMAND_ARGS_NUM;
-	} else if (strcmp(type, "exit") == 0) {
-		commandOut->type = EXIT;
-		commandOut->arguments = calloc(1, sizeof(ExitCommandArguments));
-		argsNum = EXIT_COMMAND_ARGS_NUM;
-	} else {
-		return false;
 	}
 
-	/* check if arguments allocation failed */
-	if (commandOut->arguments == NULL) {
-		/* NOTE: for now we are allowed this behaviour: */
-		printf("Error: parseCommand has failed\n");
-		exit(EXIT_FAILURE);
+	spec = findCommandSpec(token, length);
+	if (spec == NULL) {
 		return false;
 	}
+	commandOut->type = spec->type;
 
-	if (parseArgs(commandStr, commandOut->arguments, argsNum, parser)) {
-		return true;
+	for (i = 0; i < spec->argsNum; i++) {
+		token = nextCommandToken(&cursor, &length);
+		if (token == NULL) {
+			/* no remaining tokens in input can happen if expected arg count isn't reached */
+			return false;
+		}
+		if (! spec->parser(token, length, commandOut, i + 1)) {
+			return false;
+		}
 	}
 
-	return false;
+	return true;
+}
+
+/**
+ * isIndexInRange checks whether a row or column number provided by the user is within the
+ * range [1, dimension].
+ *
+ * @param index			[in] the row or column number
+ * @param dimension 	[in] the number of rows (and columns) of the board
+ * @return true 		iff index is within range
+ * @return false 		iff index is out of range
+ */
+bool isIndexInRange(int index, int dimension) {
+	return (index >= 1) && (index <= dimension);
+}
+
+bool areCommandArgumentsInRange(Command* command, int dimension) {
+	SetCommandArguments* setArgs = &(command->arguments.set);
+	HintCommandArguments* hintArgs = &(command->arguments.hint);
+
+	switch (command->type) {
+	case SET:
+		return isIndexInRange(setArgs->row, dimension) &&
+			   isIndexInRange(setArgs->col, dimension) &&
+			   (setArgs->value >= 0) && (setArgs->value <= dimension);
+	case HINT:
+		return isIndexInRange(hintArgs->row, dimension) &&
+			   isIndexInRange(hintArgs->col, dimension);
+	case VALIDATE:
+	case RESTART:
+	case EXIT:
+	case STATS:
+	case UNDO:
+	case REDO:
+	case IGNORE:
+		break;
+	}
+	return true;
 }
@@ -1,10 +1,13 @@
 /**
  * PARSER Summary:
  *
- * A module designed to parse user commands for a sudoku game.
+ * A module designed to parse user commands for a sudoku game. Parsing allocates nothing and
+ * leaves the input string as it is: the arguments of a command are kept in the Command struct
+ * itself, and the input is tokenized through a cursor owned by the caller.
  *
- * cleanupCommand - cleans up any resources allocated for a previously parsed user command
+ * nextCommandToken - finds the next token of a command string
  * parseCommand - parses a user command
+ * areCommandArgumentsInRange - checks the arguments of a parsed command against the board size
  */
 
 #ifndef PARSER_H_
@@ -26,6 +29,9 @@ typedef enum commandType {
 	VALIDATE,
 	RESTART,
 	EXIT,
+	STATS,
+	UNDO,
+	REDO,
 	IGNORE} CommandType;
 
 /**
@@ -54,54 +60,65 @@ typedef struct { /* Note: order of row and col is reverse to that provided by us
 #define HINT_COMMAND_ARGS_NUM (2)
 
 /**
- * For consistency, we use an minimal size struct to respresent the arguments of 
- * commands with no arguments: 'validate', 'restart' and 'exit'
+ * The commands 'validate', 'restart', 'exit', 'stats', 'undo' and 'redo' take no arguments.
  */
-typedef struct {
-	char dummy;
-} ValidateCommandArguments, RestartCommandArguments, ExitCommandArguments;
-
 #define VALIDATE_COMMAND_ARGS_NUM (0)
 #define RESTART_COMMAND_ARGS_NUM (0)
 #define EXIT_COMMAND_ARGS_NUM (0)
+#define STATS_COMMAND_ARGS_NUM (0)
+#define UNDO_COMMAND_ARGS_NUM (0)
+#define REDO_COMMAND_ARGS_NUM (0)
 
 /**
  * Command is a struct that represents the user's command. It has two attributes -
  * the command's type, matching one of the types defined in the commandType enum,
- * and the command's arguments, a generic pointer to the concrete arguments struct.  
+ * and the command's arguments, held in place: the member of the union matching the type
+ * ('set' or 'hint'), unused for commands with no arguments.
  */
 typedef struct {
 	CommandType type;
-	void* arguments;
-
+	union {
+		SetCommandArguments set;
+		HintCommandArguments hint;
+	} arguments;
 } Command;
 
 /**
- * Reserved for future use.
- *
- * cleanupCommand frees memory allocated by parseCommand. In case one of the command types
- * will need to allocate additional internal memory, there will be a specific cleanup
- * implementation provided.
+ * nextCommandToken finds the next token of a command string: a run of characters other than
+ * whitespaces. The string is not modified, and all the state of the tokenizer is kept in the
+ * caller's cursor, so several strings may be tokenized at once.
  *
- * @param command		the Command struct whose arguments are removed
+ * @param cursorInOut 	[in, out] a pointer to the position in the string to search from; it is
+ * 						moved past the token found
+ * @param lengthOut 	[out] the length of the token found
+ * @return const char*	the start of the token, or NULL if the string has no more tokens
  */
-void cleanupCommand(Command* command);
+const char* nextCommandToken(const char** cursorInOut, int* lengthOut);
 
 /**
  * parseCommand is used to process the user input string and initialize a command
- * struct accordingly. If arguments allocation failed due to a memory error, an error
- * message is printer out and the process is terminated.
+ * struct accordingly. Arguments beyond those the command takes are ignored.
  *
- * @param commandStr 	[in] a pointer to the input string the user provided
- * @param commandOut 	[in, out] a pointer to a Command struct, to be intilizlized
+ * @param commandStr 	[in] a pointer to the input string the user provided; it is not modified
+ * @param commandOut 	[in, out] a pointer to a Command struct, to be initialized
  * 						by parseCommand according to the user input
- * @return true 		iff the user only types whitespaces for the command name
+ * @return true 		iff the command name is one of the game's commands, and it was given
+ * 						enough valid arguments, or the user only typed whitespaces (IGNORE)
  * @return false 		iff the command name the user used does not match any of the possible
- * 						commands names in the game
+ * 						commands names in the game, or its arguments are missing or invalid
+ */
+bool parseCommand(const char* commandStr, Command* commandOut);
+
+/**
+ * areCommandArgumentsInRange checks that the arguments of a successfully parsed command fit a
+ * board of the given dimension: rows and columns must be within the range [1, dimension], and
+ * values within the range [0, dimension].
  *
- * @note	should parseCommand succeed, you must later call cleanupCommand with the command struct
- * 			returned through commandOut.
+ * @param command 		[in] a pointer to the parsed Command struct
+ * @param dimension 	[in] the number of rows (and columns) of the board
+ * @return true 		iff all the arguments of the command are within range
+ * @return false 		iff some argument of the command is out of range
  */
-bool parseCommand(char* commandStr, Command* commandOut); /* TODO: doc that cleanup must be called after successful call to this function */
+bool areCommandArgumentsInRange(Command* command, int dimension);
 
 #endif /* PARSER_H_ */
@@ -0,0 +1,406 @@
+#include "propagation.h"
+
+/**
+ * The results of a pass of propagation rules over a board.
+ */
+#define PASS_CONTRADICTION (-1)
+#define PASS_UNCHANGED (0)
+#define PASS_CHANGED (1)
+
+/**
+ * PropagationSearch struct holds the state of solveWithPropagation. Every level of the search
+ * has its own row of candidates and of empty cells (numCells entries each); the empty cells
+ * of a level are those left empty once constraints were propagated at that level. The work of
+ * the search is counted in stats.
+ */
+typedef struct {
+	Board* board;
+	int numCells;
+	unsigned int* candidates;
+	int* emptyCells;
+	RandomGenerator* generator;
+	SolverStats* stats;
+} PropagationSearch;
+
+/**
+ * getUnitCell returns a cell of a unit of a board. Units are numbered rows first, then
+ * columns, then blocks.
+ *
+ * @param board		[in] the board
+ * @param unit 		[in] the unit number, in the range [0, 3 * dimension - 1]
+ * @param index 	[in] the index of the cell within the unit, in the range [0, dimension - 1]
+ * @return int		the cell, as an index (row * dimension + col)
+ */
+int getUnitCell(Board* board, int unit, int index) {
+	int blockSize = getBlockSize(board);
+	int dimension = getBoardDimension(board);
+	int block = 0;
+
+	if (unit < dimension) {
+		return unit * dimension + index;
+	} else if (unit < 2 * dimension) {
+		return index * dimension + (unit - dimension);
+	}
+
+	block = unit - 2 * dimension;
+	return ((block / blockSize) * blockSize + index / blockSize) * dimension +
+		   (block % blockSize) * blockSize + index % blockSize;
+}
+
+/**
+ * getCellBlock returns the number of the block a cell of a board belongs to.
+ *
+ * @param board		[in] the board
+ * @param cell 		[in] the cell, as an index (row * dimension + col)
+ * @return int		the block number, blocks being numbered in row-major order
+ */
+int getCellBlock(Board* board, int cell) {
+	int blockSize = getBlockSize(board);
+	int dimension = getBoardDimension(board);
+	return ((cell / dimension) / blockSize) * blockSize + (cell % dimension) / blockSize;
+}
+
+/**
+ * getLiveCandidates returns the candidates of a cell which are still allowed by its row,
+ * column and block, and narrows the stored candidates to them.
+ *
+ * @param board				[in] the board
+ * @param candidatesInOut 	[in, out] the candidates of the board's cells
+ * @param cell 				[in] the cell, as an index (row * dimension + col)
+ * @return unsigned int		the candidates of the cell; none if it is filled
+ */
+unsigned int getLiveCandidates(Board* board, unsigned int* candidatesInOut, int cell) {
+	int dimension = getBoardDimension(board);
+	int row = cell / dimension, col = cell % dimension;
+
+	if (!isCellEmpty(board, row, col)) {
+		return 0;
+	}
+
+	candidatesInOut[cell] &= getCellCandidates(board, row, col);
+	return candidatesInOut[cell];
+}
+
+/**
+ * placeValue fills a cell of a board during propagation.
+ *
+ * @param board				[in, out] the board
+ * @param candidatesInOut 	[in, out] the candidates of the board's cells
+ * @param cell 				[in] the cell, as an index (row * dimension + col)
+ * @param value 			[in] the value, which must be valid in the cell
+ */
+void placeValue(Board* board, unsigned int* candidatesInOut, int cell, int value) {
+	int dimension = getBoardDimension(board);
+	setCellValue(board, cell / dimension, cell % dimension, value);
+	candidatesInOut[cell] = 0;
+}
+
+void initialiseCandidates(Board* board, unsigned int* candidatesOut) {
+	int dimension = getBoardDimension(board);
+	int cell = 0;
+
+	for (cell = 0; cell < dimension * dimension; cell++) {
+		int row = cell / dimension, col = cell % dimension;
+		candidatesOut[cell] = isCellEmpty(board, row, col) ? getCellCandidates(board, row, col) : 0;
+	}
+}
+
+/**
+ * applySingles runs one pass of the naked singles rule over all cells, then one pass of the
+ * hidden singles rule over all units.
+ *
+ * @param board				[in, out] the board
+ * @param candidatesInOut 	[in, out] the candidates of the board's cells
+ * @return int				PASS_CONTRADICTION, PASS_UNCHANGED or PASS_CHANGED
+ */
+int applySingles(Board* board, unsigned int* candidatesInOut) {
+	int dimension = getBoardDimension(board);
+	unsigned int allValues = (1u << dimension) - 1;
+	int result = PASS_UNCHANGED;
+	int cell = 0, unit = 0, index = 0;
+
+	for (cell = 0; cell < dimension * dimension; cell++) {
+		if (isCellEmpty(board, cell / dimension, cell % dimension)) {
+			unsigned int candidates = getLiveCandidates(board, candidatesInOut, cell);
+			if (candidates == 0) {
+				return PASS_CONTRADICTION;
+			}
+			if ((candidates & (candidates - 1)) == 0) {
+				placeValue(board, candidatesInOut, cell, getMaskValue(candidates));
+				result = PASS_CHANGED;
+			}
+		}
+	}
+
+	for (unit = 0; unit < 3 * dimension; unit++) {
+		unsigned int once = 0, twice = 0, placed = 0, missing = 0, hidden = 0;
+
+		for (index = 0; index < dimension; index++) {
+			int unitCell = getUnitCell(board, unit, index);
+			int value = getCellValue(board, unitCell / dimension, unitCell % dimension);
+			if (value != EMPTY_CELL_VALUE) {
+				placed |= 1u << (value - 1);
+			} else {
+				unsigned int candidates = getLiveCandidates(board, candidatesInOut, unitCell);
+				twice |= once & candidates;
+				once |= candidates;
+			}
+		}
+
+		missing = allValues & ~placed;
+		if ((once & missing) != missing) {
+			return PASS_CONTRADICTION;
+		}
+
+		hidden = once & ~twice;
+		for (index = 0; index < dimension && hidden != 0; index++) {
+			int unitCell = getUnitCell(board, unit, index);
+			unsigned int candidates = 0, hiddenCandidates = 0;
+
+			if (!isCellEmpty(board, unitCell / dimension, unitCell % dimension)) {
+				continue;
+			}
+			candidates = getLiveCandidates(board, candidatesInOut, unitCell);
+			hiddenCandidates = candidates & hidden;
+			if (hiddenCandidates != 0) {
+				/* two values which can only go in this cell */
+				if ((hiddenCandidates & (hiddenCandidates - 1)) != 0) {
+					return PASS_CONTRADICTION;
+				}
+				placeValue(board, candidatesInOut, unitCell, getMaskValue(hiddenCandidates));
+				hidden &= ~hiddenCandidates;
+				result = PASS_CHANGED;
+			}
+		}
+		/* a value lost its only cell to a value placed in another unit during this pass */
+		if (hidden != 0) {
+			return PASS_CONTRADICTION;
+		}
+	}
+
+	return result;
+}
+
+/**
+ * eliminateCandidates removes values from the candidates of a cell.
+ *
+ * @param candidatesInOut 	[in, out] the candidates of the board's cells
+ * @param cell 				[in] the cell, as an index (row * dimension + col)
+ * @param values 			[in] the bitmask of values to be removed
+ * @return int				PASS_CHANGED if some candidate was removed, otherwise PASS_UNCHANGED
+ */
+int eliminateCandidates(unsigned int* candidatesInOut, int cell, unsigned int values) {
+	if ((candidatesInOut[cell] & values) == 0) {
+		return PASS_UNCHANGED;
+	}
+	candidatesInOut[cell] &= ~values;
+	return PASS_CHANGED;
+}
+
+/**
+ * applyLockedCandidates runs one pass of the pointing and claiming rules, over every
+ * intersection of a block with a row or a column. The candidates of the empty cells must be
+ * live (see getLiveCandidates), and those of filled cells empty, as they are after a pass of
+ * applySingles which placed no value.
+ *
+ * @param board				[in] the board
+ * @param candidatesInOut 	[in, out] the candidates of the board's cells
+ * @return int				PASS_UNCHANGED or PASS_CHANGED
+ */
+int applyLockedCandidates(Board* board, unsigned int* candidatesInOut) {
+	int blockSize = getBlockSize(board);
+	int dimension = getBoardDimension(board);
+	int result = PASS_UNCHANGED;
+	int orientation = 0, block = 0, line = 0, index = 0;
+
+	/* rows first, then columns */
+	for (orientation = 0; orientation < 2; orientation++) {
+		bool isColumn = (orientation == 1);
+
+		for (block = 0; block < dimension; block++) {
+			int firstLine = isColumn ? (block % blockSize) * blockSize : (block / blockSize) * blockSize;
+
+			for (line = firstLine; line < firstLine + blockSize; line++) {
+				/* the intersection, the rest of the block, and the rest of the line */
+				unsigned int segment = 0, restOfBlock = 0, restOfLine = 0;
+				unsigned int pointing = 0, claiming = 0;
+				int lineUnit = isColumn ? dimension + line : line;
+				int blockUnit = 2 * dimension + block;
+
+				for (index = 0; index < dimension; index++) {
+					int cell = getUnitCell(board, blockUnit, index);
+					int cellLine = isColumn ? cell % dimension : cell / dimension;
+					if (cellLine == line) {
+						segment |= candidatesInOut[cell];
+					} else {
+						restOfBlock |= candidatesInOut[cell];
+					}
+
+					cell = getUnitCell(board, lineUnit, index);
+					if (getCellBlock(board, cell) != block) {
+						restOfLine |= candidatesInOut[cell];
+					}
+				}
+
+				pointing = segment & ~restOfBlock & restOfLine;
+				claiming = segment & ~restOfLine & restOfBlock;
+				if (pointing == 0 && claiming == 0) {
+					continue;
+				}
+
+				for (index = 0; index < dimension; index++) {
+					int cell = getUnitCell(board, lineUnit, index);
+					if (getCellBlock(board, cell) != block) {
+						result |= eliminateCandidates(candidatesInOut, cell, pointing);
+					}
+
+					cell = getUnitCell(board, blockUnit, index);
+					if ((isColumn ? cell % dimension : cell / dimension) != line) {
+						result |= eliminateCandidates(candidatesInOut, cell, claiming);
+					}
+				}
+			}
+		}
+	}
+
+	return result;
+}
+
+bool propagateConstraints(Board* board, unsigned int* candidatesInOut) {
+	while (true) {
+		int result = applySingles(board, candidatesInOut);
+		if (result == PASS_CONTRADICTION) {
+			return false;
+		}
+		if (result == PASS_UNCHANGED && applyLockedCandidates(board, candidatesInOut) == PASS_UNCHANGED) {
+			return true;
+		}
+	}
+}
+
+/**
+ * takeGuessValue removes one value from a candidates bitmask: the lowest one, or a uniformly
+ * chosen one if a generator is provided.
+ *
+ * @param candidatesInOut	[in, out] a non-empty candidates bitmask
+ * @param generator 		[in, out] the random generator choosing the value, or NULL
+ * @return int				the value removed from the bitmask
+ */
+int takeGuessValue(unsigned int* candidatesInOut, RandomGenerator* generator) {
+	unsigned int remaining = *candidatesInOut;
+	unsigned int bit = 0;
+	int skip = (generator != NULL) ? getRandomIndex(generator, countMaskValues(remaining)) : 0;
+
+	for (; skip > 0; skip--) {
+		remaining &= remaining - 1;
+	}
+	bit = remaining & (~remaining + 1);
+	*candidatesInOut &= ~bit;
+	return getMaskValue(bit);
+}
+
+/**
+ * solvePropagationRec is a recursive function (to be called by solveWithPropagation). It
+ * propagates constraints at its level, then branches on the empty cell with the fewest
+ * candidates. When a guess fails, every cell left empty at this level is emptied again, which
+ * undoes the guess along with everything deeper levels filled.
+ *
+ * @param search	[in, out] the search state; the candidates of this level must be set
+ * @param level 	[in] the level of this call
+ * @return true 	iff the board was completely filled
+ * @return false 	iff there is no solution from this level; the cells this level filled are
+ * 					left filled, to be emptied by the level above
+ */
+bool solvePropagationRec(PropagationSearch* search, int level) {
+	Board* board = search->board;
+	int dimension = getBoardDimension(board);
+	unsigned int* candidates = search->candidates + level * search->numCells;
+	int* emptyCells = search->emptyCells + level * search->numCells;
+	int numEmptyCells = 0, bestCell = 0, bestCount = dimension + 1;
+	unsigned int untried = 0;
+	int cell = 0, i = 0;
+
+	if (!propagateConstraints(board, candidates)) {
+		search->stats->numBacktracks++;
+		return false;
+	}
+
+	for (cell = 0; cell < search->numCells; cell++) {
+		if (isCellEmpty(board, cell / dimension, cell % dimension)) {
+			int count = countMaskValues(candidates[cell]);
+			search->stats->numValidityChecks++;
+			emptyCells[numEmptyCells++] = cell;
+			if (count < bestCount) {
+				bestCell = cell;
+				bestCount = count;
+			}
+		}
+	}
+
+	if (numEmptyCells == 0) {
+		return true;
+	}
+
+	untried = candidates[bestCell];
+	while (untried != 0 && recordSearchNode(search->stats, level + 1)) {
+		unsigned int* nextCandidates = candidates + search->numCells;
+		int value = takeGuessValue(&untried, search->generator);
+
+		memcpy(nextCandidates, candidates, search->numCells * sizeof(unsigned int));
+		placeValue(board, nextCandidates, bestCell, value);
+		if (solvePropagationRec(search, level + 1)) {
+			return true;
+		}
+
+		for (i = 0; i < numEmptyCells; i++) {
+			emptyCell(board, emptyCells[i] / dimension, emptyCells[i] % dimension);
+		}
+	}
+
+	if (!search->stats->hasGivenUp) {
+		search->stats->numBacktracks++;
+	}
+	return false;
+}
+
+bool solveWithPropagation(Board* board, RandomGenerator* generator, SolverStats* statsInOut) {
+	int dimension = getBoardDimension(board);
+	PropagationSearch search;
+	int* originalEmptyCells = NULL;
+	int numOriginalEmptyCells = 0;
+	bool isSolved = false;
+	int cell = 0;
+
+	search.board = board;
+	search.numCells = dimension * dimension;
+	search.generator = generator;
+	search.stats = statsInOut;
+	/* every level fills at least one cell, so there are at most numCells + 1 levels */
+	search.candidates = malloc((search.numCells + 1) * search.numCells * sizeof(unsigned int));
+	search.emptyCells = malloc((search.numCells + 2) * search.numCells * sizeof(int));
+	if (search.candidates == NULL || search.emptyCells == NULL) {
+		/* NOTE: for now we are allowed this behaviour: */
+		printf("Error: solveWithPropagation has failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* the last row of empty cells keeps those of the original board, to restore it on failure */
+	originalEmptyCells = search.emptyCells + (search.numCells + 1) * search.numCells;
+	for (cell = 0; cell < search.numCells; cell++) {
+		if (isCellEmpty(board, cell / dimension, cell % dimension)) {
+			originalEmptyCells[numOriginalEmptyCells++] = cell;
+		}
+	}
+
+	initialiseCandidates(board, search.candidates);
+	isSolved = solvePropagationRec(&search, 0);
+	if (!isSolved) {
+		for (cell = 0; cell < numOriginalEmptyCells; cell++) {
+			emptyCell(board, originalEmptyCells[cell] / dimension, originalEmptyCells[cell] % dimension);
+		}
+	}
+
+	free(search.candidates);
+	free(search.emptyCells);
+	return isSolved;
+}
@@ -0,0 +1,70 @@
+/**
+ * PROPAGATION Summary:
+ *
+ * A module designed to solve sudoku boards by constraint propagation, falling back to search
+ * only when propagation gets stuck. Alongside the board, the candidates of every empty cell
+ * are kept in an array of bitmasks (bit value - 1 for every value still possible), so that
+ * eliminations which do not follow from the board's occupancy masks alone are remembered.
+ *
+ * initialiseCandidates - sets the candidates of every cell of a board from its contents
+ * propagateConstraints - fills the cells of a board which follow from its candidates
+ * solveWithPropagation - solves a board, propagating constraints before and after every guess
+ */
+
+#ifndef PROPAGATION_H_
+#define PROPAGATION_H_
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "game.h"
+#include "random.h"
+#include "stats.h"
+
+/**
+ * initialiseCandidates sets the candidates of every cell of a board: the values allowed by its
+ * row, column and block for an empty cell, and none for a filled cell.
+ *
+ * @param board				[in] the board
+ * @param candidatesOut 	[out] an array of a bitmask per cell (in row-major order)
+ */
+void initialiseCandidates(Board* board, unsigned int* candidatesOut);
+
+/**
+ * propagateConstraints repeatedly applies the following rules until none of them applies:
+ * naked singles		- a cell with a single candidate is filled with it
+ * hidden singles		- a value which is a candidate of a single cell of a row, column or
+ * 						  block is placed in that cell
+ * pointing				- if the candidates of a value in a block all lie in one row (or column),
+ * 						  the value is eliminated from the rest of that row (or column)
+ * claiming				- if the candidates of a value in a row (or column) all lie in one block,
+ * 						  the value is eliminated from the rest of that block
+ *
+ * @param board				[in, out] the board, whose cells are filled as the rules apply
+ * @param candidatesInOut 	[in, out] the candidates of the board's cells, which are narrowed
+ * @return true 			iff no contradiction was found
+ * @return false 			iff some cell, row, column or block was left without a possible value;
+ * 							the board then has no solution, and is left partially filled
+ */
+bool propagateConstraints(Board* board, unsigned int* candidatesInOut);
+
+/**
+ * solveWithPropagation solves a given board in place. Constraints are propagated first (see
+ * propagateConstraints), and if the board is not solved by that, the search branches on the
+ * empty cell with the fewest candidates, propagating constraints again after every guess.
+ * If allocation fails, an error message is printed out and the process is terminated.
+ *
+ * @param board			[in, out] a pointer to the Board struct to be solved
+ * @param generator 	[in, out] if NULL, the candidates of a cell are tried in ascending
+ * 						order; otherwise in an order drawn from this generator
+ * @param statsInOut 	[in, out] the counters the work of the search is added to. Their budget
+ * 						applies to the search
+ * @return true 		iff the board was solved
+ * @return false 		iff the board has no solution, or the budget was exhausted first (see
+ * 						hasGivenUp); the board is then left unchanged
+ */
+bool solveWithPropagation(Board* board, RandomGenerator* generator, SolverStats* statsInOut);
+
+#endif /* PROPAGATION_H_ */
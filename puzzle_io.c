@@ -0,0 +1,642 @@
+#include "puzzle_io.h"
+
+#define COMMENT_CHAR ('#')
+#define EMPTY_CELL_CHAR ('.')
+#define ALTERNATIVE_EMPTY_CELL_CHAR ('0')
+
+#define FIRST_LETTER_VALUE (10)
+
+#define BINARY_COUNT_OFFSET (8)
+#define BINARY_COUNT_SIZE (8)
+#define BINARY_UNKNOWN_COUNT_BYTE (0xFF)
+
+/**
+ * getBinaryBitsPerCell calculates the number of bits a cell takes in a binary record.
+ *
+ * @param dimension		[in] the dimension of the board
+ * @return int			4 if every value fits in half a byte, 8 otherwise
+ */
+int getBinaryBitsPerCell(int dimension) {
+	return (dimension <= 15) ? 4 : 8;
+}
+
+/**
+ * getBinaryRecordSize calculates the size of a binary record, without its status byte.
+ *
+ * @param dimension		[in] the dimension of the board
+ * @return int			the number of bytes of the record
+ */
+int getBinaryRecordSize(int dimension) {
+	int numCells = dimension * dimension;
+	return (numCells * getBinaryBitsPerCell(dimension) + 7) / 8 + (numCells + 7) / 8;
+}
+
+/**
+ * readBinaryHeader checks whether a puzzle file starts with a binary header, which must
+ * already be in the input, and if so, consumes it and keeps its fields.
+ *
+ * @param reader	[in, out] the puzzle file, just opened
+ * @return true 	iff the file is a text file, or a binary file which can be read
+ * @return false 	iff the file is a binary file of an unknown version, block size or flags
+ */
+bool readBinaryHeader(PuzzleReader* reader) {
+	const unsigned char* header = (const unsigned char*)reader->data;
+	int blockSize = 0, i = 0;
+	bool isCountKnown = false;
+
+	reader->isBinary = false;
+	reader->binaryBlockSize = 0;
+	reader->binaryFlags = 0;
+	reader->numRecordsLeft = -1;
+	if (reader->length < BINARY_PUZZLE_HEADER_SIZE ||
+		memcmp(header, BINARY_PUZZLE_MAGIC, BINARY_PUZZLE_MAGIC_LENGTH) != 0) {
+		return true;
+	}
+
+	reader->isBinary = true;
+	reader->position = BINARY_PUZZLE_HEADER_SIZE;
+	blockSize = header[5];
+	if (blockSize == 0 && header[6] == 0) {
+		/* the header of a file without records (see finishBinaryFile) */
+		reader->numRecordsLeft = 0;
+		return header[4] == BINARY_PUZZLE_VERSION;
+	}
+	if (header[4] != BINARY_PUZZLE_VERSION || blockSize < MIN_BLOCK_SIZE || blockSize > MAX_BLOCK_SIZE ||
+		header[6] != getBinaryBitsPerCell(blockSize * blockSize) || (header[7] & ~(BINARY_PUZZLE_HAS_STATUS | BINARY_PUZZLE_HAS_SOLUTION)) != 0) {
+		return false;
+	}
+
+	reader->binaryBlockSize = blockSize;
+	reader->binaryFlags = header[7];
+	for (i = BINARY_COUNT_OFFSET + BINARY_COUNT_SIZE - 1; i >= BINARY_COUNT_OFFSET; i--) {
+		isCountKnown = isCountKnown || header[i] != BINARY_UNKNOWN_COUNT_BYTE;
+	}
+	if (isCountKnown) {
+		reader->numRecordsLeft = 0;
+		for (i = BINARY_COUNT_OFFSET + BINARY_COUNT_SIZE - 1; i >= BINARY_COUNT_OFFSET; i--) {
+			reader->numRecordsLeft = (reader->numRecordsLeft << 8) | header[i];
+		}
+	}
+	return true;
+}
+
+/**
+ * unmapPuzzleWindow unmaps the current window of a mapped puzzle file, if there is one.
+ *
+ * @param reader	[in, out] the puzzle file
+ */
+void unmapPuzzleWindow(PuzzleReader* reader) {
+	if (reader->mappedWindow != NULL) {
+		munmap(reader->mappedWindow, reader->length);
+		reader->mappedWindow = NULL;
+	}
+}
+
+/**
+ * refillPuzzleReader replaces the input of a puzzle file, all of which was read, with the
+ * next part of the file: the next window of a mapped file, which is advised to be read
+ * sequentially, or else the next buffer full.
+ *
+ * @param reader	[in, out] the puzzle file
+ * @return int		the number of characters now available, 0 if the file has ended
+ */
+int refillPuzzleReader(PuzzleReader* reader) {
+	reader->position = 0;
+
+	if (!reader->isMapped) {
+		reader->length = fread(reader->buffer, 1, PUZZLE_READER_BUFFER_SIZE, reader->file);
+		return reader->length;
+	}
+
+	unmapPuzzleWindow(reader);
+	reader->length = 0;
+	if (reader->mappedOffset < reader->fileSize) {
+		off_t length = reader->fileSize - reader->mappedOffset;
+		if (length > PUZZLE_READER_WINDOW_SIZE) {
+			length = PUZZLE_READER_WINDOW_SIZE;
+		}
+
+		reader->mappedWindow = mmap(NULL, (size_t)length, PROT_READ, MAP_PRIVATE, fileno(reader->file), reader->mappedOffset);
+		if (reader->mappedWindow == MAP_FAILED) {
+			reader->mappedWindow = NULL;
+			return 0;
+		}
+		posix_madvise(reader->mappedWindow, (size_t)length, POSIX_MADV_SEQUENTIAL);
+		reader->data = reader->mappedWindow;
+		reader->length = (int)length;
+		reader->mappedOffset += length;
+	}
+	return reader->length;
+}
+
+bool openPuzzleReader(PuzzleReader* reader, char* path) {
+	struct stat fileStatus;
+
+	if (strcmp(path, "-") == 0) {
+		reader->file = stdin;
+		reader->shouldClose = false;
+	} else {
+		reader->file = fopen(path, "rb");
+		reader->shouldClose = true;
+	}
+
+	reader->data = reader->buffer;
+	reader->length = 0;
+	reader->position = 0;
+	reader->isMapped = false;
+	reader->mappedWindow = NULL;
+	reader->mappedOffset = 0;
+	reader->fileSize = 0;
+	reader->isBinary = false;
+	reader->binaryBlockSize = 0;
+	if (reader->file == NULL) {
+		return false;
+	}
+
+	/* regular files are mapped; the window size is a multiple of the page size */
+	if (reader->shouldClose && fstat(fileno(reader->file), &fileStatus) == 0 && S_ISREG(fileStatus.st_mode) &&
+		PUZZLE_READER_WINDOW_SIZE % sysconf(_SC_PAGESIZE) == 0) {
+		reader->isMapped = true;
+		reader->fileSize = fileStatus.st_size;
+	}
+
+	/* the first window, or buffer, is enough to tell a binary header */
+	refillPuzzleReader(reader);
+	if (!readBinaryHeader(reader)) {
+		closePuzzleReader(reader);
+		return false;
+	}
+	return true;
+}
+
+int getPuzzleReaderBlockSize(PuzzleReader* reader) {
+	return reader->binaryBlockSize;
+}
+
+void closePuzzleReader(PuzzleReader* reader) {
+	unmapPuzzleWindow(reader);
+	if (reader->shouldClose && reader->file != NULL) {
+		fclose(reader->file);
+	}
+	reader->file = NULL;
+}
+
+/**
+ * nextChar returns the next character of a puzzle file, refilling its input if needed.
+ *
+ * @param reader	[in, out] the puzzle file
+ * @return int		the next character, or EOF if the file has ended
+ */
+int nextChar(PuzzleReader* reader) {
+	if (reader->position == reader->length && refillPuzzleReader(reader) == 0) {
+		return EOF;
+	}
+	return (unsigned char)reader->data[reader->position++];
+}
+
+/**
+ * readBytes reads a number of bytes of a puzzle file, refilling its input as needed.
+ *
+ * @param reader	[in, out] the puzzle file
+ * @param bytesOut 	[out] the buffer the bytes are copied to
+ * @param numBytes 	[in] the number of bytes to read
+ * @return int		the number of bytes read, less than numBytes iff the file has ended
+ */
+int readBytes(PuzzleReader* reader, unsigned char* bytesOut, int numBytes) {
+	int numRead = 0;
+
+	while (numRead < numBytes) {
+		int numAvailable = reader->length - reader->position;
+		if (numAvailable == 0) {
+			numAvailable = refillPuzzleReader(reader);
+			if (numAvailable == 0) {
+				break;
+			}
+		}
+		if (numAvailable > numBytes - numRead) {
+			numAvailable = numBytes - numRead;
+		}
+		memcpy(bytesOut + numRead, reader->data + reader->position, numAvailable);
+		reader->position += numAvailable;
+		numRead += numAvailable;
+	}
+
+	return numRead;
+}
+
+/**
+ * skipLine skips the characters of a puzzle file up to and including the next end of line.
+ *
+ * @param reader	[in, out] the puzzle file
+ */
+void skipLine(PuzzleReader* reader) {
+	int c = 0;
+	do {
+		c = nextChar(reader);
+	} while (c != '\n' && c != EOF);
+}
+
+/**
+ * symbolToValue translates a character of a puzzle file to the cell value it stands for.
+ *
+ * @param c				[in] the character
+ * @param dimension 	[in] the dimension of the board being read
+ * @return int			the value of the cell (EMPTY_CELL_VALUE for an empty cell), or -1 if
+ * 						c does not stand for a cell of a board of this dimension
+ */
+int symbolToValue(int c, int dimension) {
+	int value = -1;
+
+	if (c == EMPTY_CELL_CHAR || c == ALTERNATIVE_EMPTY_CELL_CHAR) {
+		return EMPTY_CELL_VALUE;
+	} else if ('1' <= c && c <= '9') {
+		value = c - '0';
+	} else if ('A' <= c && c <= 'Z') {
+		value = c - 'A' + FIRST_LETTER_VALUE;
+	} else if ('a' <= c && c <= 'z') {
+		value = c - 'a' + FIRST_LETTER_VALUE;
+	}
+
+	return (value <= dimension) ? value : -1;
+}
+
+/**
+ * valueToSymbol translates a cell value to the character standing for it in a puzzle file.
+ *
+ * @param value		[in] the value of the cell
+ * @return char		the matching character
+ */
+char valueToSymbol(int value) {
+	if (value == EMPTY_CELL_VALUE) {
+		return EMPTY_CELL_CHAR;
+	} else if (value < FIRST_LETTER_VALUE) {
+		return (char)('0' + value);
+	}
+	return (char)('A' + value - FIRST_LETTER_VALUE);
+}
+
+/**
+ * readBinaryPuzzle reads the next record of a binary puzzle file into a board (see readPuzzle).
+ *
+ * @param reader				[in, out] the puzzle file
+ * @param board 				[in, out] the board to be filled
+ * @return PuzzleReadResult		the outcome of reading (see PuzzleReadResult)
+ */
+PuzzleReadResult readBinaryPuzzle(PuzzleReader* reader, Board* board) {
+	unsigned char record[1 + BINARY_PUZZLE_MAX_RECORD_SIZE];
+	int blockSize = reader->binaryBlockSize;
+	int statusSize = (reader->binaryFlags & BINARY_PUZZLE_HAS_STATUS) ? 1 : 0;
+	int recordSize = statusSize + getBinaryRecordSize(blockSize * blockSize);
+	int numRead = 0;
+	int row = 0, col = 0;
+
+	if (reader->numRecordsLeft == 0) {
+		return PUZZLE_END;
+	}
+
+	numRead = readBytes(reader, record, recordSize);
+	if (numRead == 0 && reader->numRecordsLeft < 0) {
+		return PUZZLE_END;
+	}
+	if (reader->numRecordsLeft > 0) {
+		reader->numRecordsLeft--;
+	}
+
+	if (numRead < recordSize || blockSize != getBlockSize(board)) {
+		clearBoard(board);
+		return PUZZLE_INVALID;
+	}
+	if (!unpackBoard(record + statusSize, board)) {
+		return PUZZLE_INVALID;
+	}
+
+	/* keep the clues only, as the text reader does */
+	for (row = 0; row < getBoardDimension(board); row++) {
+		for (col = 0; col < getBoardDimension(board); col++) {
+			if (reader->binaryFlags & BINARY_PUZZLE_HAS_SOLUTION) {
+				if (!isCellFixed(board, row, col)) {
+					emptyCell(board, row, col);
+				}
+			} else if (!isCellEmpty(board, row, col)) {
+				fixCell(board, row, col);
+			}
+		}
+	}
+	return PUZZLE_READ;
+}
+
+PuzzleReadResult readPuzzle(PuzzleReader* reader, Board* board) {
+	int dimension = getBoardDimension(board);
+	int numCells = dimension * dimension;
+	bool isValid = true;
+	int cell = 0;
+
+	if (reader->isBinary) {
+		return readBinaryPuzzle(reader, board);
+	}
+
+	clearBoard(board);
+
+	while (cell < numCells) {
+		int c = nextChar(reader);
+		int value = 0;
+
+		if (c == EOF) {
+			return (cell == 0) ? PUZZLE_END : PUZZLE_INVALID;
+		}
+
+		if (c == COMMENT_CHAR) {
+			skipLine(reader);
+			continue;
+		}
+
+		value = symbolToValue(c, dimension);
+		if (value < 0) {
+			continue;
+		}
+
+		if (value != EMPTY_CELL_VALUE) {
+			int row = cell / dimension, col = cell % dimension;
+			if (isCellValueValid(board, row, col, value)) {
+				setCellValue(board, row, col, value);
+				fixCell(board, row, col);
+			} else {
+				isValid = false;
+			}
+		}
+		cell++;
+	}
+
+	skipLine(reader);
+	return isValid ? PUZZLE_READ : PUZZLE_INVALID;
+}
+
+int formatBoard(const Board* board, char* textOut) {
+	int dimension = getBoardDimension(board);
+	int row = 0, col = 0;
+
+	for (row = 0; row < dimension; row++)
+		for (col = 0; col < dimension; col++)
+			*(textOut++) = valueToSymbol(getCellValue(board, row, col));
+
+	return dimension * dimension;
+}
+
+int packBoard(const Board* board, unsigned char* recordOut) {
+	int dimension = getBoardDimension(board);
+	int numCells = dimension * dimension;
+	int bitsPerCell = getBinaryBitsPerCell(dimension);
+	int recordSize = getBinaryRecordSize(dimension);
+	unsigned char* fixedMap = recordOut + (numCells * bitsPerCell + 7) / 8;
+	int cell = 0;
+
+	memset(recordOut, 0, recordSize);
+	for (cell = 0; cell < numCells; cell++) {
+		int row = cell / dimension, col = cell % dimension;
+		unsigned int value = (unsigned int)getCellValue(board, row, col);
+
+		if (bitsPerCell == 4) {
+			recordOut[cell / 2] |= (unsigned char)(value << (4 * (cell % 2)));
+		} else {
+			recordOut[cell] = (unsigned char)value;
+		}
+		if (isCellFixed(board, row, col)) {
+			fixedMap[cell / 8] |= (unsigned char)(1u << (cell % 8));
+		}
+	}
+
+	return recordSize;
+}
+
+bool unpackBoard(const unsigned char* record, Board* board) {
+	int dimension = getBoardDimension(board);
+	int numCells = dimension * dimension;
+	int bitsPerCell = getBinaryBitsPerCell(dimension);
+	const unsigned char* fixedMap = record + (numCells * bitsPerCell + 7) / 8;
+	bool isValid = true;
+	int cell = 0;
+
+	clearBoard(board);
+	for (cell = 0; cell < numCells; cell++) {
+		int row = cell / dimension, col = cell % dimension;
+		int value = 0;
+
+		if (bitsPerCell == 4) {
+			value = (record[cell / 2] >> (4 * (cell % 2))) & 0x0F;
+		} else {
+			value = record[cell];
+		}
+
+		if (value != EMPTY_CELL_VALUE) {
+			if (value <= dimension && isCellValueValid(board, row, col, value)) {
+				setCellValue(board, row, col, value);
+			} else {
+				isValid = false;
+			}
+		}
+		if (fixedMap[cell / 8] & (1u << (cell % 8))) {
+			fixCell(board, row, col);
+		}
+	}
+
+	return isValid;
+}
+
+bool openPuzzleWriter(PuzzleWriter* writer, char* path) {
+	if (strcmp(path, "-") == 0) {
+		writer->file = stdout;
+		writer->shouldClose = false;
+	} else {
+		writer->file = fopen(path, "wb");
+		writer->shouldClose = true;
+	}
+
+	writer->hasFailed = false;
+	writer->length = 0;
+	writer->isBinary = strlen(path) >= strlen(BINARY_PUZZLE_EXTENSION) &&
+		strcmp(path + strlen(path) - strlen(BINARY_PUZZLE_EXTENSION), BINARY_PUZZLE_EXTENSION) == 0;
+	writer->hasHeader = false;
+	writer->numRecords = 0;
+	return writer->file != NULL;
+}
+
+/**
+ * flushPuzzleWriter writes the contents of the output buffer to the file, and empties it.
+ *
+ * @param writer	[in, out] the output file
+ */
+void flushPuzzleWriter(PuzzleWriter* writer) {
+	if (writer->length > 0) {
+		if (fwrite(writer->buffer, 1, writer->length, writer->file) != (size_t)writer->length) {
+			writer->hasFailed = true;
+		}
+		writer->length = 0;
+	}
+}
+
+/**
+ * encodeBinaryCount writes a count of records as stored in a binary header.
+ *
+ * @param count		[in] the number of records
+ * @param bytesOut 	[out] a buffer of BINARY_COUNT_SIZE bytes
+ */
+void encodeBinaryCount(unsigned long count, unsigned char* bytesOut) {
+	int i = 0;
+	for (i = 0; i < BINARY_COUNT_SIZE; i++) {
+		bytesOut[i] = (unsigned char)(count & 0xFF);
+		/* two shifts, as unsigned long may be only 32 bits wide */
+		count = (count >> 4) >> 4;
+	}
+}
+
+/**
+ * writeBinaryRecord writes a board as a record of a binary file, along with the header of the
+ * file if it is the first record.
+ *
+ * @param writer	[in, out] the output file
+ * @param status 	[in] the status of the board, or NULL for a record without a status
+ * @param board 	[in] the board to be written
+ * @param isSolution 	[in] true iff the board is a solution whose fixed cells are the clues
+ * 						of its puzzle (see BINARY_PUZZLE_HAS_SOLUTION)
+ */
+void writeBinaryRecord(PuzzleWriter* writer, char* status, Board* board, bool isSolution) {
+	unsigned char* bytes = NULL;
+
+	if (writer->length + BINARY_PUZZLE_HEADER_SIZE + 1 + BINARY_PUZZLE_MAX_RECORD_SIZE > PUZZLE_WRITER_BUFFER_SIZE) {
+		flushPuzzleWriter(writer);
+	}
+	bytes = (unsigned char*)writer->buffer + writer->length;
+
+	if (!writer->hasHeader) {
+		memcpy(bytes, BINARY_PUZZLE_MAGIC, BINARY_PUZZLE_MAGIC_LENGTH);
+		bytes[4] = BINARY_PUZZLE_VERSION;
+		bytes[5] = (unsigned char)getBlockSize(board);
+		bytes[6] = (unsigned char)getBinaryBitsPerCell(getBoardDimension(board));
+		bytes[7] = (unsigned char)(((status != NULL) ? BINARY_PUZZLE_HAS_STATUS : 0) |
+								   (isSolution ? BINARY_PUZZLE_HAS_SOLUTION : 0));
+		/* the count is filled in by closePuzzleWriter, where the file can be rewound */
+		memset(bytes + BINARY_COUNT_OFFSET, BINARY_UNKNOWN_COUNT_BYTE, BINARY_COUNT_SIZE);
+		bytes += BINARY_PUZZLE_HEADER_SIZE;
+		writer->hasHeader = true;
+	}
+
+	if (status != NULL) {
+		const char* statusNames[BINARY_PUZZLE_NUM_STATUSES] = BINARY_PUZZLE_STATUS_NAMES;
+		int i = 0;
+		*bytes = 0;
+		for (i = 0; i < BINARY_PUZZLE_NUM_STATUSES; i++) {
+			if (strcmp(status, statusNames[i]) == 0) {
+				*bytes = (unsigned char)(i + 1);
+			}
+		}
+		bytes++;
+	}
+
+	bytes += packBoard(board, bytes);
+	writer->length = (int)((char*)bytes - writer->buffer);
+	writer->numRecords++;
+}
+
+void writePuzzle(PuzzleWriter* writer, char* status, Board* board) {
+	int dimension = getBoardDimension(board);
+	int statusLength = strlen(status);
+
+	if (writer->isBinary) {
+		writeBinaryRecord(writer, status, board, false);
+		return;
+	}
+
+	/* status, space, cells and end of line */
+	if (writer->length + statusLength + dimension * dimension + 2 > PUZZLE_WRITER_BUFFER_SIZE) {
+		flushPuzzleWriter(writer);
+	}
+
+	memcpy(writer->buffer + writer->length, status, statusLength);
+	writer->length += statusLength;
+	writer->buffer[writer->length++] = ' ';
+	writer->length += formatBoard(board, writer->buffer + writer->length);
+	writer->buffer[writer->length++] = '\n';
+}
+
+void writeGeneratedPuzzle(PuzzleWriter* writer, Board* board) {
+	int dimension = getBoardDimension(board);
+	int row = 0, col = 0;
+
+	if (writer->isBinary) {
+		writeBinaryRecord(writer, NULL, board, true);
+		return;
+	}
+
+	/* puzzle, space, solution and end of line */
+	if (writer->length + 2 * dimension * dimension + 2 > PUZZLE_WRITER_BUFFER_SIZE) {
+		flushPuzzleWriter(writer);
+	}
+
+	for (row = 0; row < dimension; row++)
+		for (col = 0; col < dimension; col++)
+			writer->buffer[writer->length++] = isCellFixed(board, row, col) ?
+					valueToSymbol(getCellValue(board, row, col)) : EMPTY_CELL_CHAR;
+	writer->buffer[writer->length++] = ' ';
+	writer->length += formatBoard(board, writer->buffer + writer->length);
+	writer->buffer[writer->length++] = '\n';
+}
+
+void writeBoard(PuzzleWriter* writer, Board* board) {
+	int dimension = getBoardDimension(board);
+
+	if (writer->isBinary) {
+		writeBinaryRecord(writer, NULL, board, false);
+		return;
+	}
+
+	/* cells and end of line */
+	if (writer->length + dimension * dimension + 1 > PUZZLE_WRITER_BUFFER_SIZE) {
+		flushPuzzleWriter(writer);
+	}
+
+	writer->length += formatBoard(board, writer->buffer + writer->length);
+	writer->buffer[writer->length++] = '\n';
+}
+
+/**
+ * finishBinaryFile fills in the count of records in the header of a binary file, if the file
+ * can be rewound; otherwise the count is left unknown. A file without records is given a
+ * header of its own, with a count of 0.
+ *
+ * @param writer	[in, out] the output file, whose buffer was flushed
+ */
+void finishBinaryFile(PuzzleWriter* writer) {
+	unsigned char count[BINARY_COUNT_SIZE];
+
+	if (!writer->hasHeader) {
+		memset(writer->buffer, 0, BINARY_PUZZLE_HEADER_SIZE);
+		memcpy(writer->buffer, BINARY_PUZZLE_MAGIC, BINARY_PUZZLE_MAGIC_LENGTH);
+		writer->buffer[4] = BINARY_PUZZLE_VERSION;
+		writer->length = BINARY_PUZZLE_HEADER_SIZE;
+		writer->hasHeader = true;
+		flushPuzzleWriter(writer);
+		return;
+	}
+
+	encodeBinaryCount(writer->numRecords, count);
+	if (fflush(writer->file) == 0 && fseek(writer->file, BINARY_COUNT_OFFSET, SEEK_SET) == 0) {
+		if (fwrite(count, 1, BINARY_COUNT_SIZE, writer->file) != BINARY_COUNT_SIZE) {
+			writer->hasFailed = true;
+		}
+	}
+}
+
+bool closePuzzleWriter(PuzzleWriter* writer) {
+	flushPuzzleWriter(writer);
+	if (writer->isBinary) {
+		finishBinaryFile(writer);
+	}
+	if (fflush(writer->file) != 0) {
+		writer->hasFailed = true;
+	}
+	if (writer->shouldClose && fclose(writer->file) != 0) {
+		writer->hasFailed = true;
+	}
+	writer->file = NULL;
+	return !writer->hasFailed;
+}
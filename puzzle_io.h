@@ -0,0 +1,282 @@
+/**
+ * PUZZLE_IO Summary:
+ *
+ * A module designed to read and write sudoku puzzles in bulk, in the common text formats:
+ * one puzzle per line (e.g. 81 characters for a 9x9 board), or a multi-line grid, possibly
+ * decorated with separators such as '|', '-' and '+'. Empty cells are written as '.' or '0',
+ * values 1-9 as digits, and values from 10 on as letters ('A' for 10, 'B' for 11, ...).
+ * Lines starting with '#' are comments.
+ * Regular files are memory mapped, one window at a time, and parsed in place; other inputs,
+ * such as pipes, are read through a buffer.
+ * Puzzles may also be kept in a compact binary format (see BINARY_PUZZLE_MAGIC), which readers
+ * recognise by its header, and which writers use for paths ending with BINARY_PUZZLE_EXTENSION.
+ *
+ * openPuzzleReader - opens a puzzle file for reading
+ * getPuzzleReaderBlockSize - returns the block size recorded in a binary puzzle file
+ * readPuzzle - reads the next puzzle from a puzzle file
+ * closePuzzleReader - closes a puzzle file
+ * formatBoard - writes a board as a single line of text
+ * packBoard - writes a board as a binary record
+ * unpackBoard - reads a board from a binary record
+ * openPuzzleWriter - opens a file for writing puzzles
+ * writePuzzle - writes a puzzle, along with a status, as a line of a file
+ * writeGeneratedPuzzle - writes a generated puzzle, along with its solution, as a line of a file
+ * writeBoard - writes a board alone as a line of a file
+ * closePuzzleWriter - flushes and closes a file opened for writing puzzles
+ */
+
+#ifndef PUZZLE_IO_H_
+#define PUZZLE_IO_H_
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "game.h"
+
+/**
+ * The binary puzzle format starts with a header of BINARY_PUZZLE_HEADER_SIZE bytes:
+ * magic			- the 4 characters of BINARY_PUZZLE_MAGIC
+ * version			- BINARY_PUZZLE_VERSION
+ * block size		- the block size n of every board in the file
+ * bits per cell	- 4 for boards of up to 15 values (so a 9x9 cell takes half a byte), 8 for
+ * 					  larger boards
+ * flags			- BINARY_PUZZLE_HAS_STATUS and BINARY_PUZZLE_HAS_SOLUTION, or 0; in a file
+ * 					  with solutions, every record holds a solved board whose fixed cells are
+ * 					  the clues of its puzzle (see writeGeneratedPuzzle)
+ * count			- the number of records, in 8 bytes, least significant first; all ones if
+ * 					  it was not known when the file was written (the records then run to the
+ * 					  end of the file)
+ * It is followed by records of the same size, one per board:
+ * status			- if BINARY_PUZZLE_HAS_STATUS, a byte: 0 for none, or 1 + the index of the
+ * 					  status in BINARY_PUZZLE_STATUS_NAMES
+ * cells			- the values of the cells in row-major order, bits per cell bits each, the
+ * 					  first cell of a byte in its low bits (see packBoard)
+ * fixed cells		- a bitmap of the fixed cells, one bit per cell, low bits first
+ * A 9x9 board thus takes 52 bytes (53 with a status), where a line of text takes 82.
+ */
+#define BINARY_PUZZLE_MAGIC "SDKB"
+#define BINARY_PUZZLE_MAGIC_LENGTH (4)
+#define BINARY_PUZZLE_VERSION (1)
+#define BINARY_PUZZLE_HEADER_SIZE (16)
+#define BINARY_PUZZLE_EXTENSION ".sdkb"
+#define BINARY_PUZZLE_HAS_STATUS (0x01)
+#define BINARY_PUZZLE_HAS_SOLUTION (0x02)
+#define BINARY_PUZZLE_STATUS_NAMES {"solved", "unsolvable", "invalid"}
+#define BINARY_PUZZLE_NUM_STATUSES (3)
+
+/**
+ * The size of the largest binary record (without its status byte), for a board of
+ * MAX_DIMENSION values with one byte per cell.
+ */
+#define BINARY_PUZZLE_MAX_RECORD_SIZE (MAX_DIMENSION * MAX_DIMENSION + (MAX_DIMENSION * MAX_DIMENSION + 7) / 8)
+
+/**
+ * The size of the input buffer of a PuzzleReader, in bytes.
+ */
+#define PUZZLE_READER_BUFFER_SIZE (1 << 16)
+
+/**
+ * The size of the window of a regular file a PuzzleReader maps at a time, in bytes. Only one
+ * window is mapped at a time, so memory use does not grow with the size of the file. It must
+ * be a multiple of the page size.
+ */
+#define PUZZLE_READER_WINDOW_SIZE (1 << 24)
+
+/**
+ * PuzzleReader struct represents a puzzle file opened for reading. The characters not read
+ * yet are data[position, length): either the current window of a mapped regular file
+ * (mappedWindow, and the offset of the next window in the file, mappedOffset), or the input
+ * buffer.
+ * For a binary file, the fields of its header are kept as well: its block size (0 if it has no
+ * records), flags and the number of records left to read (-1 if unknown).
+ */
+typedef struct {
+	FILE* file;
+	bool shouldClose;
+	char buffer[PUZZLE_READER_BUFFER_SIZE];
+	const char* data;
+	int length;
+	int position;
+	bool isMapped;
+	void* mappedWindow;
+	off_t mappedOffset;
+	off_t fileSize;
+	bool isBinary;
+	int binaryBlockSize;
+	int binaryFlags;
+	long numRecordsLeft;
+} PuzzleReader;
+
+/**
+ * PuzzleReadResult enumerates the possible outcomes of reading a puzzle:
+ * PUZZLE_READ		- a puzzle was read
+ * PUZZLE_INVALID	- a puzzle was read, but its clues conflict with each other, or the input
+ * 					  ended in the middle of it
+ * PUZZLE_END		- there are no more puzzles in the input
+ */
+typedef enum puzzleReadResult {
+	PUZZLE_READ,
+	PUZZLE_INVALID,
+	PUZZLE_END} PuzzleReadResult;
+
+/**
+ * openPuzzleReader opens a puzzle file for reading.
+ *
+ * @param reader	[in, out] a pointer to the PuzzleReader struct to be initialised
+ * @param path 		[in] the path of the file, or "-" for the standard input
+ * @return true 	iff the file was opened
+ * @return false 	iff the file could not be opened, or it is a binary file of an unknown
+ * 					version or block size
+ *
+ * @note	if openPuzzleReader succeeded, you must later call closePuzzleReader with reader.
+ */
+bool openPuzzleReader(PuzzleReader* reader, char* path);
+
+/**
+ * getPuzzleReaderBlockSize returns the block size of the boards of a binary puzzle file, as
+ * recorded in its header. Text files do not record it.
+ *
+ * @param reader	[in] the puzzle file
+ * @return int		the block size of its boards, or 0 for a text file or a binary file without
+ * 					records
+ */
+int getPuzzleReaderBlockSize(PuzzleReader* reader);
+
+/**
+ * readPuzzle reads the next puzzle from a puzzle file into a board. The clues of the puzzle
+ * are set in the board and marked as fixed; all other cells are emptied. Once a puzzle is
+ * complete, the rest of its line is skipped, so single-line formats may carry trailing fields.
+ * A record of a binary file is read as the matching line of text would be: its filled cells
+ * are the clues, or only its fixed cells in a file with solutions (see
+ * BINARY_PUZZLE_HAS_SOLUTION). Its status is ignored; a record of another block size than the
+ * board's is invalid.
+ *
+ * @param reader				[in, out] the puzzle file
+ * @param board 				[in, out] the board to be filled; its size determines how many
+ * 								cells make up a puzzle
+ * @return PuzzleReadResult		the outcome of reading (see PuzzleReadResult)
+ */
+PuzzleReadResult readPuzzle(PuzzleReader* reader, Board* board);
+
+/**
+ * closePuzzleReader closes a puzzle file previously opened by openPuzzleReader.
+ *
+ * @param reader	[in, out] the puzzle file
+ */
+void closePuzzleReader(PuzzleReader* reader);
+
+/**
+ * formatBoard writes the cells of a board, in row-major order, as one character per cell
+ * (using '.' for empty cells). No terminating character is written.
+ *
+ * @param board		[in] the board to be written
+ * @param textOut 	[out] a buffer of at least n*n * n*n characters
+ * @return int		the number of characters written
+ */
+int formatBoard(const Board* board, char* textOut);
+
+/**
+ * packBoard writes the cells of a board as a binary record (see BINARY_PUZZLE_MAGIC): their
+ * values, followed by the bitmap of the fixed cells.
+ *
+ * @param board			[in] the board to be written
+ * @param recordOut 	[out] a buffer of at least BINARY_PUZZLE_MAX_RECORD_SIZE bytes
+ * @return int			the number of bytes written
+ */
+int packBoard(const Board* board, unsigned char* recordOut);
+
+/**
+ * unpackBoard reads the cells of a board from a binary record written by packBoard for a board
+ * of the same size. The conversion is lossless for every board whose values do not conflict,
+ * which are all the boards the game creates.
+ *
+ * @param record		[in] the record
+ * @param board 		[in, out] the board to be filled; all its cells are overwritten
+ * @return true 		iff every value of the record was set
+ * @return false 		iff some value is out of range, or conflicts with a value set before it,
+ * 						in which case that cell is left empty
+ */
+bool unpackBoard(const unsigned char* record, Board* board);
+
+/**
+ * The size of the output buffer of a PuzzleWriter, in bytes.
+ */
+#define PUZZLE_WRITER_BUFFER_SIZE (1 << 16)
+
+/**
+ * PuzzleWriter struct represents a file opened for writing puzzles, along with its output
+ * buffer. The buffer is only written to the file when it is full, or when the file is closed.
+ * The header of a binary file is written along with its first record, whose kind selects its
+ * flags, and its count of records is filled in when the file is closed.
+ */
+typedef struct {
+	FILE* file;
+	bool shouldClose;
+	bool hasFailed;
+	char buffer[PUZZLE_WRITER_BUFFER_SIZE];
+	int length;
+	bool isBinary;
+	bool hasHeader;
+	unsigned long numRecords;
+} PuzzleWriter;
+
+/**
+ * openPuzzleWriter opens a file for writing puzzles.
+ *
+ * @param writer	[in, out] a pointer to the PuzzleWriter struct to be initialised
+ * @param path 		[in] the path of the file, or "-" for the standard output. If it ends with
+ * 					BINARY_PUZZLE_EXTENSION, puzzles are written in the binary format
+ * @return true 	iff the file was opened
+ * @return false 	iff the file could not be opened
+ *
+ * @note	if openPuzzleWriter succeeded, you must later call closePuzzleWriter with writer.
+ */
+bool openPuzzleWriter(PuzzleWriter* writer, char* path);
+
+/**
+ * writePuzzle writes a line made of a status word, a space, and the board (see formatBoard).
+ * In a binary file, the board is written as a record carrying the status (see
+ * BINARY_PUZZLE_STATUS_NAMES).
+ *
+ * @param writer	[in, out] the output file
+ * @param status 	[in] the status word
+ * @param board 	[in] the board to be written
+ */
+void writePuzzle(PuzzleWriter* writer, char* status, Board* board);
+
+/**
+ * writeGeneratedPuzzle writes a line made of a puzzle, a space, and its solution. The board
+ * holds the solution, and its fixed cells are the clues of the puzzle: only they are written
+ * in the first part of the line, the other cells being written as empty. The line can be read
+ * back as the puzzle by readPuzzle. In a binary file, the board is written as a record of a
+ * file with solutions, which holds both, and is also read back as the puzzle.
+ *
+ * @param writer	[in, out] the output file
+ * @param board 	[in] the solved board, whose fixed cells are the puzzle's clues
+ */
+void writeGeneratedPuzzle(PuzzleWriter* writer, Board* board);
+
+/**
+ * writeBoard writes a line made of the board alone (see formatBoard), or a record without a
+ * status in a binary file. Either can be read back as the puzzle by readPuzzle.
+ *
+ * @param writer	[in, out] the output file
+ * @param board 	[in] the board to be written
+ */
+void writeBoard(PuzzleWriter* writer, Board* board);
+
+/**
+ * closePuzzleWriter flushes the output buffer and closes a file previously opened by
+ * openPuzzleWriter.
+ *
+ * @param writer	[in, out] the output file
+ * @return true 	iff all the output was written successfully
+ * @return false 	iff writing to the file has failed
+ */
+bool closePuzzleWriter(PuzzleWriter* writer);
+
+#endif /* PUZZLE_IO_H_ */
@@ -0,0 +1,78 @@
+#include "random.h"
+
+/**
+ * The increment of the splitmix32 sequence used to expand seeds into generator states.
+ */
+#define SEED_SEQUENCE_INCREMENT (0x9E3779B9u)
+
+/**
+ * rotateLeft rotates the bits of a 32 bit number to the left.
+ *
+ * @param value		[in] the number to be rotated
+ * @param shift 	[in] the number of bits to rotate by, in the range [1, 31]
+ * @return uint32_t	the rotated number
+ */
+uint32_t rotateLeft(uint32_t value, int shift) {
+	return (value << shift) | (value >> (32 - shift));
+}
+
+/**
+ * mixSeed advances a splitmix32 sequence, and returns its next (well mixed) number.
+ *
+ * @param sequenceInOut		[in, out] the state of the sequence
+ * @return uint32_t			the next number of the sequence
+ */
+uint32_t mixSeed(uint32_t* sequenceInOut) {
+	uint32_t value = (*sequenceInOut += SEED_SEQUENCE_INCREMENT);
+	value = (value ^ (value >> 16)) * 0x85EBCA6Bu;
+	value = (value ^ (value >> 13)) * 0xC2B2AE35u;
+	return value ^ (value >> 16);
+}
+
+void seedRandomGenerator(RandomGenerator* generator, unsigned long seed, unsigned long stream) {
+	/* the high halves of the arguments (if any) are folded into their low halves */
+	uint32_t sequence = (uint32_t)(seed ^ ((seed >> 16) >> 16));
+	uint32_t streamKey = (uint32_t)(stream ^ ((stream >> 16) >> 16));
+	int i = 0;
+
+	/* fold the stream into the sequence through a mixed key, so nearby streams diverge */
+	streamKey = mixSeed(&streamKey);
+	sequence ^= streamKey;
+
+	for (i = 0; i < 4; i++) {
+		generator->state[i] = mixSeed(&sequence);
+	}
+
+	/* the all-zero state is the one state xoshiro cannot leave */
+	if ((generator->state[0] | generator->state[1] | generator->state[2] | generator->state[3]) == 0) {
+		generator->state[0] = SEED_SEQUENCE_INCREMENT;
+	}
+}
+
+uint32_t getRandomNumber(RandomGenerator* generator) {
+	uint32_t* state = generator->state;
+	uint32_t result = rotateLeft(state[1] * 5, 7) * 9;
+	uint32_t shifted = state[1] << 9;
+
+	state[2] ^= state[0];
+	state[3] ^= state[1];
+	state[1] ^= state[2];
+	state[0] ^= state[3];
+	state[2] ^= shifted;
+	state[3] = rotateLeft(state[3], 11);
+
+	return result;
+}
+
+int getRandomIndex(RandomGenerator* generator, int bound) {
+	uint32_t range = (uint32_t)bound;
+	/* numbers below threshold are rejected, so every index has the same number of preimages */
+	uint32_t threshold = (0u - range) % range;
+	uint32_t value = 0;
+
+	do {
+		value = getRandomNumber(generator);
+	} while (value < threshold);
+
+	return (int)(value % range);
+}
@@ -0,0 +1,56 @@
+/**
+ * RANDOM Summary:
+ *
+ * A module designed to provide independent, reproducible streams of pseudo-random numbers.
+ * Each RandomGenerator holds its own state (the xoshiro128** algorithm), so generators can be
+ * used concurrently by different threads, and a stream can be reproduced from its seed alone.
+ *
+ * seedRandomGenerator - initialises a generator from a seed and a stream number
+ * getRandomNumber - returns the next number of a generator
+ * getRandomIndex - returns a uniformly distributed index below a bound
+ */
+
+#ifndef RANDOM_H_
+#define RANDOM_H_
+
+#include <stdint.h>
+
+/**
+ * RandomGenerator struct holds the state of a stream of pseudo-random numbers. Generators must
+ * be initialised with seedRandomGenerator before use.
+ */
+typedef struct {
+	uint32_t state[4];
+} RandomGenerator;
+
+/**
+ * seedRandomGenerator initialises a generator. Generators initialised with the same seed and
+ * stream produce the same numbers; different streams of the same seed are independent, so
+ * that e.g. the puzzle number may be used as the stream, for every puzzle to be reproducible
+ * on its own.
+ *
+ * @param generator		[out] the generator to be initialised
+ * @param seed 			[in] the seed
+ * @param stream 		[in] the stream number
+ */
+void seedRandomGenerator(RandomGenerator* generator, unsigned long seed, unsigned long stream);
+
+/**
+ * getRandomNumber advances a generator, and returns its next number.
+ *
+ * @param generator		[in, out] the generator
+ * @return uint32_t		a number uniformly distributed over all 32 bit values
+ */
+uint32_t getRandomNumber(RandomGenerator* generator);
+
+/**
+ * getRandomIndex advances a generator, and returns a number uniformly distributed in the
+ * range [0, bound - 1].
+ *
+ * @param generator		[in, out] the generator
+ * @param bound 		[in] the number of possible results; must be positive
+ * @return int			the random index
+ */
+int getRandomIndex(RandomGenerator* generator, int bound);
+
+#endif /* RANDOM_H_ */
@@ -0,0 +1,741 @@
+#include "rating.h"
+
+/**
+ * The results of a step of a technique over a board.
+ */
+#define RATING_STEP_CONTRADICTION (-1)
+#define RATING_STEP_UNCHANGED (0)
+#define RATING_STEP_CHANGED (1)
+
+/**
+ * The capacity of the trail of a Rater. Every entry of the trail removes at least one candidate
+ * of a cell, and candidates are only ever removed between two undos, so there are never more
+ * entries than candidates on a board of the largest size.
+ */
+#define RATING_TRAIL_CAPACITY (MAX_DIMENSION * MAX_DIMENSION * MAX_DIMENSION)
+
+/**
+ * Rater struct holds the state of ratePuzzle: the value and the candidates of every cell (in
+ * row-major order), and the cells of every unit, numbered rows first, then columns, then
+ * blocks. The candidates of a filled cell are empty.
+ * Every change to the candidates of a cell is recorded on the trail (the cell, and its
+ * candidates before the change), so that the search can undo its guesses in place (see
+ * undoRatedTrail). All of it has a fixed size, so rating a puzzle allocates nothing.
+ */
+typedef struct {
+	int blockSize;
+	int dimension;
+	int numCells;
+	int numEmptyCells;
+	unsigned int allValues;
+	unsigned char values[MAX_DIMENSION * MAX_DIMENSION];
+	unsigned int candidates[MAX_DIMENSION * MAX_DIMENSION];
+	unsigned char cellBlocks[MAX_DIMENSION * MAX_DIMENSION];
+	unsigned short units[3 * MAX_DIMENSION][MAX_DIMENSION];
+	int trailLength;
+	unsigned short trailCells[RATING_TRAIL_CAPACITY];
+	unsigned int trailCandidates[RATING_TRAIL_CAPACITY];
+} Rater;
+
+/**
+ * SubsetSearch struct holds the state of a search for naked or hidden subsets in a unit. The
+ * items of a naked subset are cells, masked by their candidates; those of a hidden subset are
+ * values, masked by the indices (within the unit) of the cells they are candidates of. Items
+ * which may not be part of a subset of the requested size have empty masks.
+ */
+typedef struct {
+	Rater* rater;
+	const unsigned short* cells;
+	unsigned int itemMasks[MAX_DIMENSION];
+	int size;
+	bool isHidden;
+} SubsetSearch;
+
+/**
+ * RatedSearch struct holds the state of the search which finishes a puzzle no technique makes
+ * progress on. The work of the search is counted in stats.
+ */
+typedef struct {
+	Rater* rater;
+	SolverStats* stats;
+} RatedSearch;
+
+/**
+ * narrowRatedCandidates sets the candidates of a cell to a subset of them, and records their
+ * previous value on the trail if they have changed.
+ *
+ * @param rater			[in, out] the state of the rating
+ * @param cell 			[in] the cell, as an index (row * dimension + col)
+ * @param candidates 	[in] the new candidates of the cell, a subset of its current ones
+ * @return true 		iff some candidate was removed
+ * @return false 		iff the candidates of the cell were left as they were
+ */
+bool narrowRatedCandidates(Rater* rater, int cell, unsigned int candidates) {
+	if (rater->candidates[cell] == candidates) {
+		return false;
+	}
+	rater->trailCells[rater->trailLength] = (unsigned short)cell;
+	rater->trailCandidates[rater->trailLength] = rater->candidates[cell];
+	rater->trailLength++;
+	rater->candidates[cell] = candidates;
+	return true;
+}
+
+/**
+ * undoRatedTrail restores the candidates of the cells changed since the trail had a given
+ * length, and empties the cells filled since then. The number of empty cells is left to the
+ * caller.
+ *
+ * @param rater			[in, out] the state of the rating
+ * @param trailLength 	[in] the length of the trail to go back to
+ */
+void undoRatedTrail(Rater* rater, int trailLength) {
+	while (rater->trailLength > trailLength) {
+		int cell = 0;
+		rater->trailLength--;
+		cell = rater->trailCells[rater->trailLength];
+		/* only empty cells have candidates to change, so the cell was empty before the change */
+		rater->candidates[cell] = rater->trailCandidates[rater->trailLength];
+		rater->values[cell] = EMPTY_CELL_VALUE;
+	}
+}
+
+/**
+ * placeRatedValue fills a cell, and eliminates its value from the candidates of the other
+ * cells of its row, column and block.
+ *
+ * @param rater		[in, out] the state of the rating
+ * @param cell 		[in] the cell, as an index (row * dimension + col); must be empty
+ * @param value 	[in] the value, which must be a candidate of the cell
+ */
+void placeRatedValue(Rater* rater, int cell, int value) {
+	int dimension = rater->dimension;
+	const unsigned short* rowCells = rater->units[cell / dimension];
+	const unsigned short* colCells = rater->units[dimension + cell % dimension];
+	const unsigned short* blockCells = rater->units[2 * dimension + rater->cellBlocks[cell]];
+	unsigned int bit = 1u << (value - 1);
+	int index = 0;
+
+	rater->values[cell] = (unsigned char)value;
+	narrowRatedCandidates(rater, cell, 0);
+	rater->numEmptyCells--;
+
+	for (index = 0; index < dimension; index++) {
+		if (rater->candidates[rowCells[index]] & bit) {
+			narrowRatedCandidates(rater, rowCells[index], rater->candidates[rowCells[index]] & ~bit);
+		}
+		if (rater->candidates[colCells[index]] & bit) {
+			narrowRatedCandidates(rater, colCells[index], rater->candidates[colCells[index]] & ~bit);
+		}
+		if (rater->candidates[blockCells[index]] & bit) {
+			narrowRatedCandidates(rater, blockCells[index], rater->candidates[blockCells[index]] & ~bit);
+		}
+	}
+}
+
+/**
+ * eliminateRatedCandidates removes values from the candidates of a cell.
+ *
+ * @param rater		[in, out] the state of the rating
+ * @param cell 		[in] the cell, as an index (row * dimension + col)
+ * @param values 	[in] the bitmask of values to be removed
+ * @return true 	iff some candidate was removed
+ * @return false 	iff none of the values was a candidate of the cell
+ */
+bool eliminateRatedCandidates(Rater* rater, int cell, unsigned int values) {
+	return narrowRatedCandidates(rater, cell, rater->candidates[cell] & ~values);
+}
+
+/**
+ * initialiseRater sets the units of a puzzle's board, and places the values of its filled
+ * cells one by one, starting from a board whose every cell may hold every value.
+ *
+ * @param rater		[out] the state of the rating
+ * @param puzzle 	[in] the puzzle
+ * @return true 	iff the filled cells of the puzzle do not conflict with one another
+ * @return false 	iff some value appears twice in a row, column or block
+ */
+bool initialiseRater(Rater* rater, const Board* puzzle) {
+	int blockSize = getBlockSize(puzzle);
+	int dimension = getBoardDimension(puzzle);
+	int row = 0, col = 0, cell = 0;
+
+	rater->blockSize = blockSize;
+	rater->dimension = dimension;
+	rater->numCells = dimension * dimension;
+	rater->numEmptyCells = rater->numCells;
+	rater->allValues = (1u << dimension) - 1;
+	rater->trailLength = 0;
+
+	for (row = 0; row < dimension; row++) {
+		for (col = 0; col < dimension; col++) {
+			int block = (row / blockSize) * blockSize + col / blockSize;
+			cell = row * dimension + col;
+			rater->units[row][col] = (unsigned short)cell;
+			rater->units[dimension + col][row] = (unsigned short)cell;
+			rater->units[2 * dimension + block][(row % blockSize) * blockSize + col % blockSize] = (unsigned short)cell;
+			rater->cellBlocks[cell] = (unsigned char)block;
+			rater->values[cell] = EMPTY_CELL_VALUE;
+			rater->candidates[cell] = rater->allValues;
+		}
+	}
+
+	for (cell = 0; cell < rater->numCells; cell++) {
+		int value = getCellValue(puzzle, cell / dimension, cell % dimension);
+		if (value != EMPTY_CELL_VALUE) {
+			/* a value placed in a peer of the cell has already been eliminated from it */
+			if ((rater->candidates[cell] & (1u << (value - 1))) == 0) {
+				return false;
+			}
+			placeRatedValue(rater, cell, value);
+		}
+	}
+
+	return true;
+}
+
+/**
+ * applyHiddenSingles runs one pass of the hidden singles technique over all units.
+ *
+ * @param rater		[in, out] the state of the rating
+ * @return int		RATING_STEP_CONTRADICTION, RATING_STEP_UNCHANGED or RATING_STEP_CHANGED
+ */
+int applyHiddenSingles(Rater* rater) {
+	int dimension = rater->dimension;
+	int result = RATING_STEP_UNCHANGED;
+	int unit = 0, index = 0;
+
+	for (unit = 0; unit < 3 * dimension; unit++) {
+		const unsigned short* cells = rater->units[unit];
+		unsigned int once = 0, twice = 0, placed = 0, hidden = 0;
+
+		for (index = 0; index < dimension; index++) {
+			int cell = cells[index];
+			if (rater->values[cell] != EMPTY_CELL_VALUE) {
+				placed |= 1u << (rater->values[cell] - 1);
+			} else {
+				twice |= once & rater->candidates[cell];
+				once |= rater->candidates[cell];
+			}
+		}
+
+		/* some value can go nowhere in the unit */
+		if ((once | placed) != rater->allValues) {
+			return RATING_STEP_CONTRADICTION;
+		}
+
+		hidden = once & ~twice;
+		for (index = 0; index < dimension && hidden != 0; index++) {
+			int cell = cells[index];
+			unsigned int hiddenCandidates = rater->candidates[cell] & hidden;
+			if (hiddenCandidates != 0) {
+				/* two values which can only go in this cell */
+				if ((hiddenCandidates & (hiddenCandidates - 1)) != 0) {
+					return RATING_STEP_CONTRADICTION;
+				}
+				placeRatedValue(rater, cell, getMaskValue(hiddenCandidates));
+				hidden &= ~hiddenCandidates;
+				result = RATING_STEP_CHANGED;
+			}
+		}
+		/* a value lost its only cell to a value placed in the same cell */
+		if (hidden != 0) {
+			return RATING_STEP_CONTRADICTION;
+		}
+	}
+
+	return result;
+}
+
+/**
+ * applyNakedSingles runs one pass of the naked singles technique over all cells.
+ *
+ * @param rater		[in, out] the state of the rating
+ * @return int		RATING_STEP_CONTRADICTION, RATING_STEP_UNCHANGED or RATING_STEP_CHANGED
+ */
+int applyNakedSingles(Rater* rater) {
+	int result = RATING_STEP_UNCHANGED;
+	int cell = 0;
+
+	for (cell = 0; cell < rater->numCells; cell++) {
+		unsigned int candidates = rater->candidates[cell];
+		if (rater->values[cell] != EMPTY_CELL_VALUE) {
+			continue;
+		}
+		if (candidates == 0) {
+			return RATING_STEP_CONTRADICTION;
+		}
+		if ((candidates & (candidates - 1)) == 0) {
+			placeRatedValue(rater, cell, getMaskValue(candidates));
+			result = RATING_STEP_CHANGED;
+		}
+	}
+
+	return result;
+}
+
+/**
+ * applyLockedCandidatesRating runs one pass of the locked candidates technique (pointing and
+ * claiming) over every intersection of a block with a row or a column.
+ *
+ * @param rater		[in, out] the state of the rating
+ * @return int		RATING_STEP_UNCHANGED or RATING_STEP_CHANGED
+ */
+int applyLockedCandidatesRating(Rater* rater) {
+	int blockSize = rater->blockSize;
+	int dimension = rater->dimension;
+	int result = RATING_STEP_UNCHANGED;
+	int block = 0, i = 0, index = 0;
+
+	for (block = 0; block < dimension; block++) {
+		const unsigned short* blockCells = rater->units[2 * dimension + block];
+		int firstRow = (block / blockSize) * blockSize;
+		int firstCol = (block % blockSize) * blockSize;
+
+		/* the rows crossing the block first, then the columns */
+		for (i = 0; i < 2 * blockSize; i++) {
+			bool isColumn = (i >= blockSize);
+			int line = isColumn ? firstCol + i - blockSize : firstRow + i;
+			const unsigned short* lineCells = rater->units[isColumn ? dimension + line : line];
+			/* the intersection, the rest of the block, and the rest of the line */
+			unsigned int segment = 0, restOfBlock = 0, restOfLine = 0;
+			unsigned int pointing = 0, claiming = 0;
+
+			for (index = 0; index < dimension; index++) {
+				int cell = blockCells[index];
+				if ((isColumn ? cell % dimension : cell / dimension) == line) {
+					segment |= rater->candidates[cell];
+				} else {
+					restOfBlock |= rater->candidates[cell];
+				}
+
+				cell = lineCells[index];
+				if (rater->cellBlocks[cell] != block) {
+					restOfLine |= rater->candidates[cell];
+				}
+			}
+
+			pointing = segment & ~restOfBlock & restOfLine;
+			claiming = segment & ~restOfLine & restOfBlock;
+			if (pointing == 0 && claiming == 0) {
+				continue;
+			}
+
+			for (index = 0; index < dimension; index++) {
+				int cell = lineCells[index];
+				if (rater->cellBlocks[cell] != block) {
+					eliminateRatedCandidates(rater, cell, pointing);
+				}
+
+				cell = blockCells[index];
+				if ((isColumn ? cell % dimension : cell / dimension) != line) {
+					eliminateRatedCandidates(rater, cell, claiming);
+				}
+			}
+			result = RATING_STEP_CHANGED;
+		}
+	}
+
+	return result;
+}
+
+/**
+ * eliminateSubset applies a naked or hidden subset found in a unit: the values of a naked
+ * subset are eliminated from the other cells of the unit, and the cells of a hidden subset are
+ * left with the values of the subset only.
+ *
+ * @param search		[in, out] the search which found the subset
+ * @param items 		[in] the bitmask of the items of the subset
+ * @param itemsUnion 	[in] the union of the masks of these items
+ * @return true 		iff some candidate was removed
+ * @return false 		iff the subset removed nothing
+ */
+bool eliminateSubset(SubsetSearch* search, unsigned int items, unsigned int itemsUnion) {
+	Rater* rater = search->rater;
+	bool isChanged = false;
+	int index = 0;
+
+	for (index = 0; index < rater->dimension; index++) {
+		int cell = search->cells[index];
+		unsigned int indexBit = 1u << index;
+
+		if (search->isHidden && (itemsUnion & indexBit) != 0) {
+			isChanged |= eliminateRatedCandidates(rater, cell, ~items);
+		} else if (!search->isHidden && (items & indexBit) == 0) {
+			isChanged |= eliminateRatedCandidates(rater, cell, itemsUnion);
+		}
+	}
+
+	return isChanged;
+}
+
+/**
+ * findSubsetRec is a recursive function (to be called by applySubsets). It tries every way of
+ * adding items, from the given one onwards, to a partial subset, and applies every subset of
+ * the requested size whose masks have as many bits in their union as it has items.
+ *
+ * @param search		[in, out] the search state
+ * @param first 		[in] the first item which may be added
+ * @param numItems 		[in] the number of items in the partial subset
+ * @param items 		[in] the bitmask of the items in the partial subset
+ * @param itemsUnion 	[in] the union of the masks of these items
+ * @return true 		iff some subset removed a candidate
+ * @return false 		iff no subset removed anything
+ */
+bool findSubsetRec(SubsetSearch* search, int first, int numItems, unsigned int items, unsigned int itemsUnion) {
+	bool isChanged = false;
+	int item = 0;
+
+	if (numItems == search->size) {
+		return (countMaskValues(itemsUnion) == search->size) && eliminateSubset(search, items, itemsUnion);
+	}
+
+	for (item = first; item < search->rater->dimension; item++) {
+		unsigned int nextUnion = itemsUnion | search->itemMasks[item];
+		if (search->itemMasks[item] != 0 && countMaskValues(nextUnion) <= search->size) {
+			isChanged |= findSubsetRec(search, item + 1, numItems + 1, items | (1u << item), nextUnion);
+		}
+	}
+
+	return isChanged;
+}
+
+/**
+ * applySubsets runs one pass of the naked or hidden subsets technique, for subsets of a given
+ * size, over all units.
+ *
+ * @param rater		[in, out] the state of the rating
+ * @param size 		[in] the number of cells (and values) in a subset
+ * @param isHidden 	[in] true for hidden subsets, false for naked subsets
+ * @return int		RATING_STEP_UNCHANGED or RATING_STEP_CHANGED
+ */
+int applySubsets(Rater* rater, int size, bool isHidden) {
+	int dimension = rater->dimension;
+	int result = RATING_STEP_UNCHANGED;
+	SubsetSearch search;
+	int unit = 0, index = 0, numItems = 0;
+
+	search.rater = rater;
+	search.size = size;
+	search.isHidden = isHidden;
+
+	for (unit = 0; unit < 3 * dimension; unit++) {
+		unsigned int unitCandidates[MAX_DIMENSION];
+		int numEmptyCells = 0;
+
+		search.cells = rater->units[unit];
+		for (index = 0; index < dimension; index++) {
+			unitCandidates[index] = rater->candidates[search.cells[index]];
+			numEmptyCells += (unitCandidates[index] != 0);
+		}
+		/* a subset of every empty cell of the unit removes nothing */
+		if (numEmptyCells <= size) {
+			continue;
+		}
+
+		if (isHidden) {
+			memset(search.itemMasks, 0, sizeof(search.itemMasks));
+			for (index = 0; index < dimension; index++) {
+				unsigned int candidates = unitCandidates[index];
+				while (candidates != 0) {
+					search.itemMasks[getMaskValue(candidates) - 1] |= 1u << index;
+					candidates &= candidates - 1;
+				}
+			}
+		} else {
+			memcpy(search.itemMasks, unitCandidates, sizeof(search.itemMasks));
+		}
+
+		/* singles are left to the singles techniques */
+		numItems = 0;
+		for (index = 0; index < dimension; index++) {
+			int count = countMaskValues(search.itemMasks[index]);
+			if (count < 2 || count > size) {
+				search.itemMasks[index] = 0;
+			} else {
+				numItems++;
+			}
+		}
+
+		if (numItems >= size && findSubsetRec(&search, 0, 0, 0, 0)) {
+			result = RATING_STEP_CHANGED;
+		}
+	}
+
+	return result;
+}
+
+/**
+ * applyXWings runs one pass of the X-wing technique, for every value, over pairs of rows and
+ * then over pairs of columns.
+ *
+ * @param rater		[in, out] the state of the rating
+ * @return int		RATING_STEP_UNCHANGED or RATING_STEP_CHANGED
+ */
+int applyXWings(Rater* rater) {
+	int dimension = rater->dimension;
+	int result = RATING_STEP_UNCHANGED;
+	unsigned int positions[MAX_DIMENSION];
+	int orientation = 0, value = 0, line = 0, otherLine = 0, index = 0;
+
+	/* rows first (with columns crossing them), then columns */
+	for (orientation = 0; orientation < 2; orientation++) {
+		int firstUnit = orientation * dimension, firstCrossUnit = (1 - orientation) * dimension;
+
+		for (value = 1; value <= dimension; value++) {
+			unsigned int bit = 1u << (value - 1);
+
+			for (line = 0; line < dimension; line++) {
+				positions[line] = 0;
+				for (index = 0; index < dimension; index++) {
+					if ((rater->candidates[rater->units[firstUnit + line][index]] & bit) != 0) {
+						positions[line] |= 1u << index;
+					}
+				}
+			}
+
+			for (line = 0; line < dimension; line++) {
+				if (countMaskValues(positions[line]) != 2) {
+					continue;
+				}
+				for (otherLine = line + 1; otherLine < dimension; otherLine++) {
+					unsigned int crossLines = positions[line];
+					if (positions[otherLine] != crossLines) {
+						continue;
+					}
+
+					/* the value is in one of the two lines in each of the two crossing lines */
+					while (crossLines != 0) {
+						const unsigned short* crossCells = rater->units[firstCrossUnit + getMaskValue(crossLines) - 1];
+						for (index = 0; index < dimension; index++) {
+							if (index != line && index != otherLine &&
+								eliminateRatedCandidates(rater, crossCells[index], bit)) {
+								result = RATING_STEP_CHANGED;
+							}
+						}
+						crossLines &= crossLines - 1;
+					}
+				}
+			}
+		}
+	}
+
+	return result;
+}
+
+/**
+ * applyRatingTechnique runs one step of a technique over the board.
+ *
+ * @param rater			[in, out] the state of the rating
+ * @param technique 	[in] the technique, other than TECHNIQUE_NONE and TECHNIQUE_SEARCH
+ * @return int			RATING_STEP_CONTRADICTION, RATING_STEP_UNCHANGED or RATING_STEP_CHANGED
+ */
+int applyRatingTechnique(Rater* rater, RatingTechnique technique) {
+	switch (technique) {
+	case TECHNIQUE_HIDDEN_SINGLE:
+		return applyHiddenSingles(rater);
+	case TECHNIQUE_NAKED_SINGLE:
+		return applyNakedSingles(rater);
+	case TECHNIQUE_LOCKED_CANDIDATES:
+		return applyLockedCandidatesRating(rater);
+	case TECHNIQUE_NAKED_PAIR:
+		return applySubsets(rater, 2, false);
+	case TECHNIQUE_HIDDEN_PAIR:
+		return applySubsets(rater, 2, true);
+	case TECHNIQUE_NAKED_TRIPLE:
+		return applySubsets(rater, 3, false);
+	case TECHNIQUE_HIDDEN_TRIPLE:
+		return applySubsets(rater, 3, true);
+	case TECHNIQUE_X_WING:
+		return applyXWings(rater);
+	case TECHNIQUE_NONE:
+	case TECHNIQUE_SEARCH:
+		break;
+	}
+	return RATING_STEP_UNCHANGED;
+}
+
+/**
+ * propagateRatedSearch applies the singles and locked candidates techniques until none of them
+ * makes progress, as the search does at every level (see solveWithPropagation).
+ *
+ * @param rater		[in, out] the state of the rating
+ * @return true 	iff no contradiction was found
+ * @return false 	iff the board has no solution
+ */
+bool propagateRatedSearch(Rater* rater) {
+	while (rater->numEmptyCells > 0) {
+		int technique = TECHNIQUE_HIDDEN_SINGLE;
+		int result = RATING_STEP_UNCHANGED;
+
+		for (; technique <= TECHNIQUE_LOCKED_CANDIDATES && result == RATING_STEP_UNCHANGED; technique++) {
+			result = applyRatingTechnique(rater, (RatingTechnique)technique);
+		}
+		if (result == RATING_STEP_CONTRADICTION) {
+			return false;
+		}
+		if (result == RATING_STEP_UNCHANGED) {
+			break;
+		}
+	}
+	return true;
+}
+
+/**
+ * searchRatedRec is a recursive function (to be called by searchRatedPuzzle). It propagates
+ * constraints at its level (see propagateRatedSearch), then branches on the empty cell with
+ * the fewest candidates. Every guess which failed is undone through the trail, back to where
+ * it was before the guess (see undoRatedTrail).
+ *
+ * @param search	[in, out] the search state
+ * @param level 	[in] the level of this call
+ * @return true 	iff the board was completely filled
+ * @return false 	iff there is no solution from this level, or the budget was exhausted
+ */
+bool searchRatedRec(RatedSearch* search, int level) {
+	Rater* rater = search->rater;
+	int numCells = rater->numCells;
+	int numEmptyCells = 0, trailLength = 0, bestCell = 0, bestCount = rater->dimension + 1;
+	unsigned int untried = 0;
+	int cell = 0;
+
+	if (!propagateRatedSearch(rater)) {
+		search->stats->numBacktracks++;
+		return false;
+	}
+	if (rater->numEmptyCells == 0) {
+		return true;
+	}
+
+	for (cell = 0; cell < numCells; cell++) {
+		if (rater->values[cell] == EMPTY_CELL_VALUE) {
+			int count = countMaskValues(rater->candidates[cell]);
+			search->stats->numValidityChecks++;
+			if (count < bestCount) {
+				bestCell = cell;
+				bestCount = count;
+			}
+		}
+	}
+
+	numEmptyCells = rater->numEmptyCells;
+	trailLength = rater->trailLength;
+
+	untried = rater->candidates[bestCell];
+	while (untried != 0 && recordSearchNode(search->stats, level + 1)) {
+		placeRatedValue(rater, bestCell, getMaskValue(untried));
+		untried &= untried - 1;
+		if (searchRatedRec(search, level + 1)) {
+			return true;
+		}
+
+		undoRatedTrail(rater, trailLength);
+		rater->numEmptyCells = numEmptyCells;
+	}
+
+	if (!search->stats->hasGivenUp) {
+		search->stats->numBacktracks++;
+	}
+	return false;
+}
+
+/**
+ * searchRatedPuzzle solves the rest of a puzzle which no technique makes progress on by
+ * search, and records the search in its rating.
+ *
+ * @param rater				[in, out] the state of the rating; the board is left solved if the
+ * 							search succeeded
+ * @param budget 			[in] the budget of the search, or NULL for no limit
+ * @param ratingOut 		[in, out] the rating of the puzzle
+ * @return SolverStatus		the result of the search (see ratePuzzle)
+ */
+SolverStatus searchRatedPuzzle(Rater* rater, const SearchBudget* budget, PuzzleRating* ratingOut) {
+	RatedSearch search;
+	SolverStats stats;
+	bool isSolved = false;
+
+	search.rater = rater;
+	search.stats = &stats;
+
+	startSearchBudget(&stats, budget);
+	isSolved = searchRatedRec(&search, 0);
+
+	ratingOut->hardestTechnique = TECHNIQUE_SEARCH;
+	ratingOut->numSteps[TECHNIQUE_SEARCH]++;
+	ratingOut->searchDepth = stats.maxDepth;
+	ratingOut->searchNodes = stats.numNodes;
+
+	if (isSolved) {
+		return SOLVER_SOLVED;
+	}
+	return stats.hasGivenUp ? SOLVER_GAVE_UP : SOLVER_UNSOLVABLE;
+}
+
+SolverStatus ratePuzzle(const Board* puzzle, const SearchBudget* budget, PuzzleRating* ratingOut) {
+	Rater rater;
+
+	memset(ratingOut, 0, sizeof(PuzzleRating));
+	ratingOut->hardestTechnique = TECHNIQUE_NONE;
+
+	if (!initialiseRater(&rater, puzzle)) {
+		return SOLVER_UNSOLVABLE;
+	}
+
+	while (rater.numEmptyCells > 0) {
+		int technique = TECHNIQUE_HIDDEN_SINGLE;
+		int result = RATING_STEP_UNCHANGED;
+
+		/* the easiest technique which makes progress is the one used */
+		for (; technique < TECHNIQUE_SEARCH; technique++) {
+			result = applyRatingTechnique(&rater, (RatingTechnique)technique);
+			if (result != RATING_STEP_UNCHANGED) {
+				break;
+			}
+		}
+
+		if (result == RATING_STEP_CONTRADICTION) {
+			return SOLVER_UNSOLVABLE;
+		}
+		if (technique == TECHNIQUE_SEARCH) {
+			return searchRatedPuzzle(&rater, budget, ratingOut);
+		}
+
+		ratingOut->numSteps[technique]++;
+		if (technique > (int)ratingOut->hardestTechnique) {
+			ratingOut->hardestTechnique = (RatingTechnique)technique;
+		}
+	}
+
+	return SOLVER_SOLVED;
+}
+
+DifficultyTier getDifficultyTier(const PuzzleRating* rating) {
+	switch (rating->hardestTechnique) {
+	case TECHNIQUE_NONE:
+	case TECHNIQUE_HIDDEN_SINGLE:
+	case TECHNIQUE_NAKED_SINGLE:
+		return TIER_EASY;
+	case TECHNIQUE_LOCKED_CANDIDATES:
+		return TIER_MEDIUM;
+	case TECHNIQUE_NAKED_PAIR:
+	case TECHNIQUE_HIDDEN_PAIR:
+	case TECHNIQUE_NAKED_TRIPLE:
+	case TECHNIQUE_HIDDEN_TRIPLE:
+		return TIER_HARD;
+	case TECHNIQUE_X_WING:
+		return TIER_EXPERT;
+	case TECHNIQUE_SEARCH:
+		break;
+	}
+	return TIER_EXTREME;
+}
+
+const char* getRatingTechniqueName(RatingTechnique technique) {
+	static const char* const names[NUM_RATING_TECHNIQUES] = RATING_TECHNIQUE_NAMES;
+	return names[technique];
+}
+
+const char* getDifficultyTierName(DifficultyTier tier) {
+	static const char* const names[NUM_DIFFICULTY_TIERS] = DIFFICULTY_TIER_NAMES;
+	return names[tier];
+}
@@ -0,0 +1,149 @@
+/**
+ * RATING Summary:
+ *
+ * A module designed to rate the difficulty of sudoku puzzles by the logical techniques a human
+ * solver would need: the puzzle is solved by the easiest technique which makes progress, time
+ * after time, and rated by the hardest technique it had to use. Puzzles which no technique of
+ * the module solves are finished by search, and rated by the depth of that search.
+ * The candidates of every empty cell are kept in bitmasks (bit value - 1 for every value still
+ * possible), which every placement and elimination narrows in place, so that a 9x9 puzzle is
+ * rated in microseconds, without allocating.
+ * The singles and locked candidates techniques are not taken from propagation.h: its passes
+ * apply naked and hidden singles together, while a rating must attribute every step to the
+ * single technique which made it.
+ *
+ * ratePuzzle - rates the difficulty of a puzzle
+ * getDifficultyTier - returns the difficulty tier of a rated puzzle
+ * getRatingTechniqueName - returns the name of a technique
+ * getDifficultyTierName - returns the name of a difficulty tier
+ */
+
+#ifndef RATING_H_
+#define RATING_H_
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "game.h"
+#include "solver.h"
+#include "stats.h"
+
+/**
+ * RatingTechnique enumerates the techniques used to rate a puzzle, from the easiest to the
+ * hardest:
+ * TECHNIQUE_NONE				- the puzzle had no empty cells
+ * TECHNIQUE_HIDDEN_SINGLE		- a value which is a candidate of a single cell of a row, column
+ * 								  or block is placed in that cell
+ * TECHNIQUE_NAKED_SINGLE		- a cell with a single candidate is filled with it
+ * TECHNIQUE_LOCKED_CANDIDATES	- if the candidates of a value in a block all lie in one row (or
+ * 								  column), the value is eliminated from the rest of that row (or
+ * 								  column), and vice versa
+ * TECHNIQUE_NAKED_PAIR			- if two cells of a unit (row, column or block) have the same two
+ * 								  candidates, these are eliminated from the rest of the unit
+ * TECHNIQUE_HIDDEN_PAIR		- if two values of a unit are candidates of the same two cells only,
+ * 								  the other candidates of these cells are eliminated
+ * TECHNIQUE_NAKED_TRIPLE		- as TECHNIQUE_NAKED_PAIR, for three cells and three values
+ * TECHNIQUE_HIDDEN_TRIPLE		- as TECHNIQUE_HIDDEN_PAIR, for three values and three cells
+ * TECHNIQUE_X_WING				- if the candidates of a value in two rows lie in the same two
+ * 								  columns, the value is eliminated from the rest of these columns
+ * 								  (and the same with rows and columns swapped)
+ * TECHNIQUE_SEARCH				- none of the above makes progress, the rest is solved by search
+ */
+typedef enum {
+	TECHNIQUE_NONE,
+	TECHNIQUE_HIDDEN_SINGLE,
+	TECHNIQUE_NAKED_SINGLE,
+	TECHNIQUE_LOCKED_CANDIDATES,
+	TECHNIQUE_NAKED_PAIR,
+	TECHNIQUE_HIDDEN_PAIR,
+	TECHNIQUE_NAKED_TRIPLE,
+	TECHNIQUE_HIDDEN_TRIPLE,
+	TECHNIQUE_X_WING,
+	TECHNIQUE_SEARCH} RatingTechnique;
+
+#define NUM_RATING_TECHNIQUES (TECHNIQUE_SEARCH + 1)
+#define RATING_TECHNIQUE_NAMES {"none", "hidden-single", "naked-single", "locked-candidates", "naked-pair", \
+								"hidden-pair", "naked-triple", "hidden-triple", "x-wing", "search"}
+
+/**
+ * DifficultyTier enumerates the tiers puzzles are bucketed into, by their hardest technique:
+ * TIER_EASY		- singles only (or no empty cells at all)
+ * TIER_MEDIUM		- locked candidates
+ * TIER_HARD		- naked or hidden pairs and triples
+ * TIER_EXPERT		- X-wing
+ * TIER_EXTREME		- search
+ */
+typedef enum {
+	TIER_EASY,
+	TIER_MEDIUM,
+	TIER_HARD,
+	TIER_EXPERT,
+	TIER_EXTREME} DifficultyTier;
+
+#define NUM_DIFFICULTY_TIERS (TIER_EXTREME + 1)
+#define DIFFICULTY_TIER_NAMES {"easy", "medium", "hard", "expert", "extreme"}
+
+/**
+ * PuzzleRating struct holds the rating of a puzzle:
+ * hardestTechnique		- the hardest technique which had to be used to solve it
+ * numSteps				- the number of steps made by each technique; a step is a pass of the
+ * 						  technique over the whole board which made progress, or for
+ * 						  TECHNIQUE_SEARCH, the search itself
+ * searchDepth			- the largest number of nested guesses the search had made at once, or 0
+ * 						  if the puzzle was solved without search
+ * searchNodes			- the number of guesses the search had made, or 0 if the puzzle was
+ * 						  solved without search
+ */
+typedef struct {
+	RatingTechnique hardestTechnique;
+	int numSteps[NUM_RATING_TECHNIQUES];
+	int searchDepth;
+	long searchNodes;
+} PuzzleRating;
+
+/**
+ * ratePuzzle rates the difficulty of a puzzle. Starting from its filled cells, the easiest
+ * technique which makes progress is applied (see RatingTechnique), and the techniques are
+ * tried from the easiest again, until the puzzle is solved or no technique makes progress. In
+ * the latter case, the rest of the puzzle is solved by search, which branches on the cell with
+ * the fewest candidates, and applies the singles and locked candidates techniques after every
+ * guess (as solveWithPropagation does).
+ * The techniques are sound whether or not the puzzle has a unique solution; a puzzle with
+ * several solutions is typically rated TECHNIQUE_SEARCH.
+ * A game's puzzle may be rated as it is being played, through viewPuzzle.
+ *
+ * @param puzzle 			[in] the puzzle to be rated; it is not modified
+ * @param budget 			[in] the budget of the search, or NULL for no limit
+ * @param ratingOut 		[out] the rating of the puzzle, if it was solved
+ * @return SolverStatus		SOLVER_SOLVED iff the puzzle was solved, and so rated,
+ * 							SOLVER_UNSOLVABLE iff it has no solution, and SOLVER_GAVE_UP iff
+ * 							the budget of the search was exhausted before it could tell
+ */
+SolverStatus ratePuzzle(const Board* puzzle, const SearchBudget* budget, PuzzleRating* ratingOut);
+
+/**
+ * getDifficultyTier returns the difficulty tier of a rated puzzle, by its hardest technique.
+ *
+ * @param rating 			[in] the rating of the puzzle
+ * @return DifficultyTier	the tier of the puzzle
+ */
+DifficultyTier getDifficultyTier(const PuzzleRating* rating);
+
+/**
+ * getRatingTechniqueName returns the name of a technique (see RATING_TECHNIQUE_NAMES).
+ *
+ * @param technique 	[in] the technique
+ * @return const char*	its name
+ */
+const char* getRatingTechniqueName(RatingTechnique technique);
+
+/**
+ * getDifficultyTierName returns the name of a difficulty tier (see DIFFICULTY_TIER_NAMES).
+ *
+ * @param tier 			[in] the tier
+ * @return const char*	its name
+ */
+const char* getDifficultyTierName(DifficultyTier tier);
+
+#endif /* RATING_H_ */
@@ -1,4 +1,46 @@
 #include "solver.h"
+#include "dlx.h"
+#include "kernel.h"
+#include "parallel.h"
+#include "propagation.h"
+#include "timing.h"
+
+/**
+ * The engine currently used by solveBoard (see setSolverEngine).
+ */
+static SolverEngine currentEngine = BACKTRACKING_ENGINE;
+
+/**
+ * The configuration of PARALLEL_ENGINE (see setParallelSearch).
+ */
+static int numParallelThreads = 1;
+static bool isParallelSearchDeterministic = true;
+
+/**
+ * Whether searches propagate constraints (see setConstraintPropagation).
+ */
+static bool isPropagationEnabled = false;
+
+void setSolverEngine(SolverEngine engine) {
+	currentEngine = engine;
+}
+
+SolverEngine getSolverEngine() {
+	return currentEngine;
+}
+
+void setParallelSearch(int numThreads, bool isDeterministic) {
+	numParallelThreads = numThreads;
+	isParallelSearchDeterministic = isDeterministic;
+}
+
+void setConstraintPropagation(bool isEnabled) {
+	isPropagationEnabled = isEnabled;
+}
+
+bool isConstraintPropagationEnabled() {
+	return isPropagationEnabled;
+}
 
 /**
  * solvePuzzleRec is a recursive function (to be called by solvePuzzle). It is used to
@@ -9,19 +51,22 @@
  * @param solution		[in, out]  a pointer to a Board struct whose cell will be set						
  * @param curRow 		[in] row number of the cell currently being set
  * @param curCol 		[in] column number of the cell currently being set
+ * @param depth 		[in] the number of cells filled by the search so far
+ * @param stats 		[in, out] the counters the work of the search is added to
  * @return true 		iff the halting condition was reached: the board is completely
  * 						filled
- * @return false 		iff there exists no valid value to set in the current cell, and
- * 						its value was set to EMPTY_CELL_VALUE.
+ * @return false 		iff there exists no valid value to set in the current cell, or the
+ * 						budget of stats was exhausted, and its value was set to EMPTY_CELL_VALUE.
  */
-bool solvePuzzleRec(Board* solution, int curRow, int curCol) {
+bool solvePuzzleRec(Board* solution, int curRow, int curCol, int depth, SolverStats* stats) {
+	int dimension = getBoardDimension(solution);
 	int nextRow = 0, nextCol = 0;
 	int value = 0;
 
-	if (curRow == N_SQUARE)
+	if (curRow == dimension)
 		return true;
 
-	if (curCol == N_SQUARE - 1) {
+	if (curCol == dimension - 1) {
 		nextRow = curRow + 1;
 		nextCol = 0;
 	} else {
@@ -30,30 +75,537 @@ bool solvePuzzleRec(Board* solution, int curRow, int curCol) {
 	}
 
 	if (! isCellEmpty(solution, curRow, curCol)) {
-		return solvePuzzleRec(solution, nextRow, nextCol);
+		return solvePuzzleRec(solution, nextRow, nextCol, depth, stats);
 	}
 
-	for (value = 1; value <= N_SQUARE; value++) {
-		if (isCellValueValid(solution, curRow, curCol, value)) {
+	for (value = 1; value <= dimension && !stats->hasGivenUp; value++) {
+		stats->numValidityChecks++;
+		if (isCellValueValid(solution, curRow, curCol, value) && recordSearchNode(stats, depth + 1)) {
 			setCellValue(solution, curRow, curCol, value);
-			if (solvePuzzleRec(solution, nextRow, nextCol)) {
+			if (solvePuzzleRec(solution, nextRow, nextCol, depth + 1, stats)) {
 				return true;
 			}
 		}
 	}
 	emptyCell(solution, curRow, curCol);
+	if (!stats->hasGivenUp) {
+		stats->numBacktracks++;
+	}
 	return false;
 }
 
-bool solvePuzzle(State* state, Board* solutionOut) {
-	Board board;
-	exportBoard(state, &board);
+/**
+ * selectMRVCell finds, among the empty cells in the worklist, the one with the fewest
+ * candidates. The search stops as soon as a cell with at most one candidate is found.
+ *
+ * @param board				[in] the board currently being solved
+ * @param emptyCells 		[in] the worklist of empty cells, as indices (row * dimension + col)
+ * @param numEmptyCells 	[in] the number of cells in the worklist
+ * @param candidatesOut 	[out] the candidates bitmask of the selected cell
+ * @param stats 			[in, out] if not NULL, the counters every candidates check is added to
+ * @return int				the index in the worklist of the selected cell
+ */
+int selectMRVCell(Board* board, int* emptyCells, int numEmptyCells, unsigned int* candidatesOut, SolverStats* stats) {
+	int dimension = getBoardDimension(board);
+	int bestIndex = 0, bestCount = dimension + 1;
+	int i = 0;
+
+	for (i = 0; i < numEmptyCells; i++) {
+		int row = emptyCells[i] / dimension, col = emptyCells[i] % dimension;
+		unsigned int candidates = getCellCandidates(board, row, col);
+		int count = countMaskValues(candidates);
+		if (stats != NULL) {
+			stats->numValidityChecks++;
+		}
+		if (count < bestCount) {
+			bestIndex = i;
+			bestCount = count;
+			*candidatesOut = candidates;
+			if (count <= 1) {
+				break;
+			}
+		}
+	}
+
+	return bestIndex;
+}
+
+/**
+ * solveMRV solves a given board in place using the minimum remaining values engine, run by
+ * the kernel specialized for the board's size (see kernel.h).
+ *
+ * @param board		[in, out] a pointer to the Board struct to be solved
+ * @param stats 	[in, out] the counters the work of the search is added to. Their budget
+ * 					applies to the search
+ * @return true 	iff the board was solved
+ * @return false 	iff the board has no solution, or the budget was exhausted first, in
+ * 					which case it is left unchanged
+ */
+bool solveMRV(Board* board, SolverStats* stats) {
+	return searchWithKernel(board, 1, true, stats) > 0;
+}
+
+int countSolutions(Board* board, int limit) {
+	if (limit <= 0)
+		return 0;
+
+	return searchWithKernel(board, limit, false, NULL);
+}
+
+int fixUniqueClues(Board* board, int numCellsToFill, RandomGenerator* generator) {
+	int dimension = getBoardDimension(board);
+	Board* puzzle = createBoard(getBlockSize(board));
+	int cellOrder[MAX_DIMENSION * MAX_DIMENSION] = {0};
+	int numClues = dimension * dimension;
+	int i = 0;
+
+	copyBoard(puzzle, board);
+
+	for (i = 0; i < numClues; i++)
+		cellOrder[i] = i;
+
+	/* Fisher-Yates shuffle of the order in which clue removal is attempted */
+	for (i = numClues - 1; i > 0; i--) {
+		int j = getRandomIndex(generator, i + 1);
+		int temp = cellOrder[i];
+		cellOrder[i] = cellOrder[j];
+		cellOrder[j] = temp;
+	}
+
+	for (i = 0; i < dimension * dimension && numClues > numCellsToFill; i++) {
+		int row = cellOrder[i] / dimension, col = cellOrder[i] % dimension;
+		int value = getCellValue(puzzle, row, col);
+
+		emptyCell(puzzle, row, col);
+		if (countSolutions(puzzle, 2) == 1) {
+			numClues--;
+		} else {
+			setCellValue(puzzle, row, col, value);
+		}
+	}
+
+	for (i = 0; i < dimension * dimension; i++)
+		if (! isCellEmpty(puzzle, i / dimension, i % dimension))
+			fixCell(board, i / dimension, i % dimension);
+
+	destroyBoard(puzzle);
+	return numClues;
+}
+
+/**
+ * SearchFrame struct represents one level of the explicit search stack of a SolverContext:
+ * the cell filled at that level (as an index, row * dimension + col), and the candidates for
+ * it that were not tried yet.
+ */
+typedef struct {
+	int cell;
+	unsigned int untriedCandidates;
+} SearchFrame;
+
+/**
+ * SolverContext struct represents a resumable search. Its worklist and stack are placed in
+ * the same heap block, right after the struct itself. The first (numEmptyCells - depth)
+ * entries of the worklist are the cells still empty; the cell of stack level i is kept at
+ * emptyCells[numEmptyCells - 1 - i]. When shouldDescend is set, the next step opens a new
+ * stack level; otherwise it tries the next candidate of the top level. stats counts the work
+ * of every step so far.
+ */
+struct SolverContext {
+	Board* board;
+	int* emptyCells;
+	SearchFrame* stack;
+	int numEmptyCells;
+	int depth;
+	bool shouldDescend;
+	RandomGenerator* generator;
+	SolverStatus status;
+	SolverStats stats;
+};
+
+/**
+ * allocateSolverContext allocates a search context over a copy of a board, with an empty
+ * worklist, at the root of the search. If allocation fails, an error message is printed out
+ * and the process is terminated.
+ *
+ * @param board				[in] the board to be copied
+ * @param generator 		[in, out] the random generator ordering the candidates, or NULL to
+ * 							try them in ascending order
+ * @return SolverContext*	a pointer to the new search context
+ */
+SolverContext* allocateSolverContext(Board* board, RandomGenerator* generator) {
+	int dimension = getBoardDimension(board);
+	int numCells = dimension * dimension;
+	SolverContext* context = calloc(1, sizeof(SolverContext) + numCells * (sizeof(SearchFrame) + sizeof(int)));
+	if (context == NULL) {
+		/* NOTE: for now we are allowed this behaviour: */
+		printf("Error: createSolverContext has failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	context->stack = (SearchFrame*)(context + 1);
+	context->emptyCells = (int*)(context->stack + numCells);
+	context->board = createBoard(getBlockSize(board));
+	copyBoard(context->board, board);
+
+	context->numEmptyCells = 0;
+	context->depth = 0;
+	context->shouldDescend = true;
+	context->generator = generator;
+	context->status = SOLVER_RUNNING;
+	resetSolverStats(&(context->stats));
+	return context;
+}
+
+SolverContext* createSolverContext(Board* board, RandomGenerator* generator) {
+	int dimension = getBoardDimension(board);
+	int row = 0, col = 0;
+	SolverContext* context = allocateSolverContext(board, generator);
+
+	for (row = 0; row < dimension; row++)
+		for (col = 0; col < dimension; col++)
+			if (isCellEmpty(board, row, col))
+				context->emptyCells[context->numEmptyCells++] = row * dimension + col;
+
+	return context;
+}
+
+int splitSolverContext(SolverContext* context, SolverContext** childrenOut) {
+	int dimension = getBoardDimension(context->board);
+	int numRemaining = context->numEmptyCells - context->depth;
+	unsigned int candidates = 0;
+	int chosenIndex = 0, cell = 0, value = 0;
+	int numChildren = 0;
+
+	if (context->depth != 0 || context->status != SOLVER_RUNNING || numRemaining == 0)
+		return 0;
+
+	chosenIndex = selectMRVCell(context->board, context->emptyCells, numRemaining, &candidates, NULL);
+	if (candidates == 0)
+		return 0;
+	cell = context->emptyCells[chosenIndex];
+
+	for (value = 1; value <= dimension; value++) {
+		if (candidates & (1u << (value - 1))) {
+			/* the worklist is passed on as a recursive search would: the chosen cell swapped to its end */
+			SolverContext* child = allocateSolverContext(context->board, context->generator);
+			memcpy(child->emptyCells, context->emptyCells, numRemaining * sizeof(int));
+			child->emptyCells[chosenIndex] = context->emptyCells[numRemaining - 1];
+			child->numEmptyCells = numRemaining - 1;
+			setCellValue(child->board, cell / dimension, cell % dimension, value);
+			recordSearchNode(&(child->stats), 1);
+			childrenOut[numChildren++] = child;
+		}
+	}
+
+	return numChildren;
+}
+
+/**
+ * takeCandidate removes one candidate from a candidates bitmask: the lowest one, or a
+ * uniformly chosen one if a generator is provided.
+ *
+ * @param candidatesInOut	[in, out] a non-empty candidates bitmask
+ * @param generator 		[in, out] the random generator choosing the candidate, or NULL
+ * @return int				the value removed from the bitmask
+ */
+int takeCandidate(unsigned int* candidatesInOut, RandomGenerator* generator) {
+	int skip = (generator != NULL) ? getRandomIndex(generator, countMaskValues(*candidatesInOut)) : 0;
+	int value = 0;
+
+	for (value = 1; value <= MAX_DIMENSION; value++) {
+		unsigned int bit = 1u << (value - 1);
+		if ((*candidatesInOut & bit) && (skip-- == 0)) {
+			*candidatesInOut &= ~bit;
+			break;
+		}
+	}
+	return value;
+}
+
+SolverStatus solverStep(SolverContext* context, long maxNodes) {
+	int dimension = getBoardDimension(context->board);
+	long numNodes = 0;
+
+	while (context->status == SOLVER_RUNNING && numNodes < maxNodes) {
+		SearchFrame* top = NULL;
+
+		if (context->shouldDescend) {
+			int numRemaining = context->numEmptyCells - context->depth;
+			int chosenIndex = 0, cell = 0;
+			unsigned int candidates = 0;
+
+			if (numRemaining == 0) {
+				context->status = SOLVER_SOLVED;
+				break;
+			}
+
+			chosenIndex = selectMRVCell(context->board, context->emptyCells, numRemaining, &candidates, &(context->stats));
+			if (candidates == 0) {
+				/* dead end: leave the worklist as it is and backtrack */
+				context->stats.numBacktracks++;
+				context->shouldDescend = false;
+				if (context->depth == 0) {
+					context->status = SOLVER_UNSOLVABLE;
+				}
+				continue;
+			}
+			cell = context->emptyCells[chosenIndex];
+			context->emptyCells[chosenIndex] = context->emptyCells[numRemaining - 1];
+			context->emptyCells[numRemaining - 1] = cell;
+
+			context->stack[context->depth].cell = cell;
+			context->stack[context->depth].untriedCandidates = candidates;
+			context->depth++;
+			context->shouldDescend = false;
+		}
+
+		top = &(context->stack[context->depth - 1]);
+		if (top->untriedCandidates == 0) {
+			/* backtrack: every value of the top cell failed */
+			emptyCell(context->board, top->cell / dimension, top->cell % dimension);
+			context->stats.numBacktracks++;
+			context->depth--;
+			if (context->depth == 0) {
+				context->status = SOLVER_UNSOLVABLE;
+			}
+		} else if (!recordSearchNode(&(context->stats), context->depth)) {
+			context->status = SOLVER_GAVE_UP;
+		} else {
+			int value = takeCandidate(&(top->untriedCandidates), context->generator);
+			setCellValue(context->board, top->cell / dimension, top->cell % dimension, value);
+			context->shouldDescend = true;
+			numNodes++;
+		}
+	}
+
+	return context->status;
+}
+
+void exportSolverBoard(SolverContext* context, Board* boardOut) {
+	copyBoard(boardOut, context->board);
+}
+
+void addSolverContextStats(SolverContext* context, SolverStats* totalInOut) {
+	addSolverStats(totalInOut, &(context->stats));
+}
+
+void destroySolverContext(SolverContext* context) {
+	if (context != NULL) {
+		destroyBoard(context->board);
+		free(context);
+	}
+}
+
+/**
+ * The number of nodes solveIterative lets the search visit between checks of its status.
+ */
+#define ITERATIVE_NODES_PER_STEP (4096)
+
+/**
+ * solveIterative fills a given board in place by running a resumable search to completion.
+ *
+ * @param board				[in, out] a pointer to the Board struct to be filled
+ * @param generator 		[in, out] the random generator ordering the candidates, or NULL to
+ * 							try them in ascending order
+ * @param stats 			[in, out] the counters the work of the search is added to. Their
+ * 							budget applies to the search
+ * @return true 			iff the board was filled
+ * @return false 			iff the board has no solution, or the budget was exhausted first, in
+ * 							which case it is left unchanged
+ */
+bool solveIterative(Board* board, RandomGenerator* generator, SolverStats* stats) {
+	SolverContext* context = createSolverContext(board, generator);
+	SolverStatus status = SOLVER_RUNNING;
+
+	/* the search goes on from the given counters, so that their budget applies to it */
+	context->stats = *stats;
+
+	while (status == SOLVER_RUNNING) {
+		status = solverStep(context, ITERATIVE_NODES_PER_STEP);
+	}
+
+	if (status == SOLVER_SOLVED) {
+		exportSolverBoard(context, board);
+	}
+
+	*stats = context->stats;
+	destroySolverContext(context);
+	return status == SOLVER_SOLVED;
+}
+
+/**
+ * solveWithEngine solves a given board in place, using the currently selected engine.
+ *
+ * @param board		[in, out] a pointer to the Board struct to be solved
+ * @param stats 	[in, out] the counters the work of the search is added to. Their budget
+ * 					applies to the search
+ * @return true 	iff the board was solved
+ * @return false 	iff the board has no solution, or the budget was exhausted first, in
+ * 					which case it is left unchanged
+ */
+bool solveWithEngine(Board* board, SolverStats* stats) {
+	if (isPropagationEnabled && currentEngine != DLX_ENGINE && currentEngine != PARALLEL_ENGINE) {
+		return solveWithPropagation(board, NULL, stats);
+	}
+
+	switch (currentEngine) {
+	case MRV_ENGINE:
+		return solveMRV(board, stats);
+	case DLX_ENGINE:
+		return solveBoardDLX(board, stats);
+	case ITERATIVE_ENGINE:
+		return solveIterative(board, NULL, stats);
+	case PARALLEL_ENGINE:
+		return solveBoardParallel(board, numParallelThreads, isParallelSearchDeterministic, stats);
+	case BACKTRACKING_ENGINE:
+		break;
+	}
+	return solvePuzzleRec(board, 0, 0, 0, stats);
+}
+
+/**
+ * getSearchStatus tells the result of a finished search from whether it succeeded and from its
+ * counters.
+ *
+ * @param isSuccessful		[in] whether the search filled the board
+ * @param stats 			[in] the counters of the search
+ * @return SolverStatus		SOLVER_SOLVED, SOLVER_GAVE_UP or SOLVER_UNSOLVABLE
+ */
+SolverStatus getSearchStatus(bool isSuccessful, const SolverStats* stats) {
+	if (isSuccessful)
+		return SOLVER_SOLVED;
+	return stats->hasGivenUp ? SOLVER_GAVE_UP : SOLVER_UNSOLVABLE;
+}
+
+SolverStatus solveBoard(Board* board, const SearchBudget* budget, SolverStats* statsOut) {
+	SolverStats stats;
+	bool isSolved = false;
 
-	if (solvePuzzleRec(&board, 0, 0)) {
-		*solutionOut = board;
+	startSearchBudget(&stats, budget);
+	stats.seconds = getWallClockSeconds();
+	isSolved = solveWithEngine(board, &stats);
+	stats.seconds = getWallClockSeconds() - stats.seconds;
+	if (statsOut != NULL) {
+		*statsOut = stats;
+	}
+	return getSearchStatus(isSolved, &stats);
+}
+
+SolverStatus solvePuzzle(State* state, Board* solutionOut, const SearchBudget* budget, SolverStats* statsOut) {
+	SolverStatus status = SOLVER_UNSOLVABLE;
+	Board* board = createBoard(getGameBlockSize(state));
+	exportBoard(state, board);
+
+	status = solveBoard(board, budget, statsOut);
+	if (status == SOLVER_SOLVED) {
+		copyBoard(solutionOut, board);
+	}
+
+	destroyBoard(board);
+	return status;
+}
+
+/**
+ * markPeers marks every cell sharing a row, a column or a block with a given cell.
+ *
+ * @param board			[in] the board
+ * @param row 			[in] the row number of the cell
+ * @param col 			[in] the column number of the cell
+ * @param isMarkedOut 	[in, out] a flag per cell (in row-major order), set for every peer
+ */
+void markPeers(const Board* board, int row, int col, bool* isMarkedOut) {
+	int blockSize = getBlockSize(board);
+	int dimension = getBoardDimension(board);
+	int firstRow = (row / blockSize) * blockSize, firstCol = (col / blockSize) * blockSize;
+	int i = 0;
+
+	for (i = 0; i < dimension; i++) {
+		isMarkedOut[row * dimension + i] = true;
+		isMarkedOut[i * dimension + col] = true;
+		isMarkedOut[(firstRow + i / blockSize) * dimension + firstCol + i % blockSize] = true;
+	}
+}
+
+/**
+ * getRemainingBudget computes what is left of a budget after a search has used some of it.
+ *
+ * @param budget			[in] the budget, or NULL for no limit
+ * @param stats 			[in] the counters of the search which used it
+ * @param remainingOut 		[out] assigned with the rest of the budget (0 meaning no limit, as
+ * 							in SearchBudget)
+ * @return true 			iff some of the budget is left
+ * @return false 			iff some limit of the budget has been reached
+ */
+bool getRemainingBudget(const SearchBudget* budget, const SolverStats* stats, SearchBudget* remainingOut) {
+	bool hasBudgetLeft = true;
+
+	remainingOut->maxNodes = 0;
+	remainingOut->maxSeconds = 0;
+	if (budget == NULL)
 		return true;
+
+	if (budget->maxNodes > 0) {
+		remainingOut->maxNodes = budget->maxNodes - stats->numNodes;
+		hasBudgetLeft = remainingOut->maxNodes > 0;
 	}
-	return false;
+	if (budget->maxSeconds > 0) {
+		remainingOut->maxSeconds = budget->maxSeconds - stats->seconds;
+		hasBudgetLeft = hasBudgetLeft && remainingOut->maxSeconds > 0;
+	}
+	return hasBudgetLeft;
+}
+
+SolverStatus solvePuzzleIncrementally(State* state, Board* solutionOut, const SearchBudget* budget, SolverStats* statsOut) {
+	bool isAffected[MAX_DIMENSION * MAX_DIMENSION] = {false};
+	const Board* storedSolution = viewSolution(state);
+	Board* board = createBoard(getGameBlockSize(state));
+	int dimension = getBoardDimension(board);
+	SolverStats stats, fallbackStats;
+	SearchBudget remainingBudget;
+	SolverStatus status = SOLVER_UNSOLVABLE;
+	int row = 0, col = 0;
+
+	exportBoard(state, board);
+
+	for (row = 0; row < dimension; row++)
+		for (col = 0; col < dimension; col++)
+			if (!isCellEmpty(board, row, col) &&
+				getCellValue(board, row, col) != getCellValue(storedSolution, row, col))
+				markPeers(board, row, col, isAffected);
+
+	/* the cells away from the deviations keep their stored values, as long as they still fit */
+	for (row = 0; row < dimension; row++) {
+		for (col = 0; col < dimension; col++) {
+			int value = getCellValue(storedSolution, row, col);
+			if (!isAffected[row * dimension + col] && isCellEmpty(board, row, col) &&
+				isCellValueValid(board, row, col, value)) {
+				setCellValue(board, row, col, value);
+			}
+		}
+	}
+
+	status = solveBoard(board, budget, &stats);
+	if (status == SOLVER_UNSOLVABLE) {
+		/* the search from scratch only gets what is left of the budget */
+		if (getRemainingBudget(budget, &stats, &remainingBudget)) {
+			exportBoard(state, board);
+			status = solveBoard(board, &remainingBudget, &fallbackStats);
+			addSolverStats(&stats, &fallbackStats);
+		} else {
+			stats.hasGivenUp = true;
+			status = SOLVER_GAVE_UP;
+		}
+	}
+
+	if (status == SOLVER_SOLVED) {
+		copyBoard(solutionOut, board);
+	}
+	if (statsOut != NULL) {
+		*statsOut = stats;
+	}
+
+	destroyBoard(board);
+	return status;
 }
 
 /**
@@ -65,22 +617,26 @@ bool solvePuzzle(State* state, Board* solutionOut) {
  * @param board		[in, out] the board currently being filled 
  * @param curRow 	[in] row number of the cell currently being set
  * @param curCol 	[in] column number of the cell currently being set	
+ * @param generator [in, out] the random generator selecting the values
+ * @param depth 	[in] the number of cells filled by the search so far
+ * @param stats 	[in, out] the counters the work of the search is added to
  * @return true		iff the halting condition was reached: the board is completely
  * 					filled
- * @return false 	iff there exists no valid value to set in the current cell, and
- * 					its value was set to EMPTY_CELL_VALUE.
+ * @return false 	iff there exists no valid value to set in the current cell, or the
+ * 					budget of stats was exhausted, and its value was set to EMPTY_CELL_VALUE.
  */
-bool generatePuzzleRec(Board* board, int curRow, int curCol) {
+bool generatePuzzleRec(Board* board, int curRow, int curCol, RandomGenerator* generator, int depth, SolverStats* stats) {
+	int dimension = getBoardDimension(board);
 	int nextRow = 0, nextCol = 0;
 	int value = 0;
-	int potentialValues[N_SQUARE] = {0};
+	int potentialValues[MAX_DIMENSION] = {0};
 	int numPotentialValues = 0;
 
 	/* If the board is completely filled */
-	if (curRow == N_SQUARE)
+	if (curRow == dimension)
 		return true;
 
-	if (curCol == N_SQUARE - 1) {
+	if (curCol == dimension - 1) {
 		nextRow = curRow + 1;
 		nextCol = 0;
 	} else {
@@ -89,20 +645,22 @@ bool generatePuzzleRec(Board* board, int curRow, int curCol) {
 	}
 
 	if (! isCellEmpty(board, curRow, curCol)) {
-		return generatePuzzleRec(board, nextRow, nextCol);
+		return generatePuzzleRec(board, nextRow, nextCol, generator, depth, stats);
 	}
 
-	for (value = 1; value <= N_SQUARE; value++) /* NOTE: could improve complexity of this */
+	for (value = 1; value <= dimension; value++) { /* NOTE: could improve complexity of this */
+		stats->numValidityChecks++;
 		if (isCellValueValid(board, curRow, curCol, value))
 			potentialValues[numPotentialValues++] = value;
+	}
 
-	while (numPotentialValues > 0) {
+	while (numPotentialValues > 0 && recordSearchNode(stats, depth + 1)) {
 		int chosenIndex = 0;
 		if (numPotentialValues > 1) {
-			chosenIndex = rand() % numPotentialValues;
+			chosenIndex = getRandomIndex(generator, numPotentialValues);
 		}
 		setCellValue(board, curRow, curCol, potentialValues[chosenIndex]);
-		if (generatePuzzleRec(board, nextRow, nextCol)) {
+		if (generatePuzzleRec(board, nextRow, nextCol, generator, depth + 1, stats)) {
 			return true;
 		} else {
 			/* NOTE: this is the smart way (complexity-wise) of doing this -
@@ -115,11 +673,31 @@ bool generatePuzzleRec(Board* board, int curRow, int curCol) {
 	}
 
 	emptyCell(board, curRow, curCol);
+	if (!stats->hasGivenUp) {
+		stats->numBacktracks++;
+	}
 	return false;
 }
 
-bool generatePuzzle(Board* board) {
-	return generatePuzzleRec(board, 0, 0);
+SolverStatus generatePuzzle(Board* board, RandomGenerator* generator, const SearchBudget* budget, SolverStats* statsOut) {
+	SolverStats stats;
+	bool isGenerated = false;
+
+	startSearchBudget(&stats, budget);
+	stats.seconds = getWallClockSeconds();
+	if (isPropagationEnabled) {
+		isGenerated = solveWithPropagation(board, generator, &stats);
+	} else if (currentEngine == ITERATIVE_ENGINE) {
+		isGenerated = solveIterative(board, generator, &stats);
+	} else {
+		isGenerated = generatePuzzleRec(board, 0, 0, generator, 0, &stats);
+	}
+	stats.seconds = getWallClockSeconds() - stats.seconds;
+
+	if (statsOut != NULL) {
+		*statsOut = stats;
+	}
+	return getSearchStatus(isGenerated, &stats);
 }
 
 /* Note: potentially those two functions (randomised vs. deterministic) could be
@@ -3,8 +3,23 @@
  *
  * A module designed to generate and solve sudoku puzzle using a certain algorithm
  *
+ * setSolverEngine - selects the algorithm used for solving puzzles
+ * getSolverEngine - returns the algorithm currently used for solving puzzles
+ * setParallelSearch - configures the threads used by the parallel engine
+ * setConstraintPropagation - selects whether searches propagate constraints
+ * isConstraintPropagationEnabled - checks whether searches propagate constraints
+ * solveBoard - solves a sudoku board in place
  * solvePuzzle - solves a sudoku puzzle
+ * solvePuzzleIncrementally - solves a sudoku puzzle, reusing its stored solution where possible
  * generatePuzzle - generated a sudoku puzzle
+ * countSolutions - counts the solutions of a sudoku board, up to some limit
+ * fixUniqueClues - selects the fixed cells of a puzzle so that it has a unique solution
+ * createSolverContext - starts a resumable search over a sudoku board
+ * splitSolverContext - splits a resumable search into searches over its subtrees
+ * solverStep - runs a bounded slice of a resumable search
+ * exportSolverBoard - exports the board of a resumable search
+ * addSolverContextStats - adds the counters of a resumable search to a running total
+ * destroySolverContext - frees a resumable search
  */
 
 
@@ -12,29 +27,257 @@
 #define SOLVER_H_
 
 #include "game.h"
+#include "stats.h"
+
+/**
+ * SolverEngine enumerates the algorithms available for solving a puzzle:
+ * BACKTRACKING_ENGINE	- deterministic backtracking over the cells in row-major order
+ * MRV_ENGINE			- deterministic backtracking which always branches on the empty cell
+ * 						  with the fewest candidates (minimum remaining values), run by the
+ * 						  kernel specialized for the board's size (see kernel.h)
+ * DLX_ENGINE			- exact cover search with Dancing Links (see dlx.h)
+ * ITERATIVE_ENGINE		- the minimum remaining values search, run without recursion on an
+ * 						  explicit search stack (see createSolverContext)
+ * PARALLEL_ENGINE		- the minimum remaining values search, split over several threads
+ * 						  (see parallel.h and setParallelSearch)
+ */
+typedef enum solverEngine {
+	BACKTRACKING_ENGINE,
+	MRV_ENGINE,
+	DLX_ENGINE,
+	ITERATIVE_ENGINE,
+	PARALLEL_ENGINE} SolverEngine;
+
+/**
+ * SolverStatus enumerates the possible states of a search, and so the possible results of
+ * solving or generating a board:
+ * SOLVER_RUNNING		- the search has not finished yet (only for a resumable search, which may
+ * 						  be resumed with solverStep)
+ * SOLVER_SOLVED		- the board has been completely filled
+ * SOLVER_UNSOLVABLE	- the search space was exhausted, the board has no solution
+ * SOLVER_GAVE_UP		- the budget of the search was exhausted before it could tell (see
+ * 						  SearchBudget)
+ */
+typedef enum solverStatus {
+	SOLVER_RUNNING,
+	SOLVER_SOLVED,
+	SOLVER_UNSOLVABLE,
+	SOLVER_GAVE_UP} SolverStatus;
+
+/**
+ * setSolverEngine selects the algorithm used by solveBoard and solvePuzzle from now on.
+ * The default engine is BACKTRACKING_ENGINE.
+ *
+ * @param engine	[in] the engine to be used
+ */
+void setSolverEngine(SolverEngine engine);
+
+/**
+ * getSolverEngine returns the algorithm currently used by solveBoard and solvePuzzle.
+ *
+ * @return SolverEngine		the engine currently selected
+ */
+SolverEngine getSolverEngine();
+
+/**
+ * setParallelSearch configures how PARALLEL_ENGINE solves a board from now on. By default, it
+ * runs on a single thread, deterministically.
+ *
+ * @param numThreads 		[in] the number of threads to search on
+ * @param isDeterministic 	[in] whether the solution found must be the one MRV_ENGINE would
+ * 							find (see solveBoardParallel)
+ */
+void setParallelSearch(int numThreads, bool isDeterministic);
+
+/**
+ * setConstraintPropagation selects whether solving and generation propagate constraints
+ * (see propagation.h) before searching and after every guess. When enabled, solveBoard and
+ * solvePuzzle use propagation in place of BACKTRACKING_ENGINE, MRV_ENGINE and ITERATIVE_ENGINE
+ * (DLX_ENGINE and PARALLEL_ENGINE are not affected), and generatePuzzle fills the board with a
+ * randomized propagating search. Disabled by default.
+ *
+ * @param isEnabled		[in] whether constraints are propagated
+ */
+void setConstraintPropagation(bool isEnabled);
+
+/**
+ * isConstraintPropagationEnabled checks whether solving and generation propagate constraints
+ * (see setConstraintPropagation).
+ *
+ * @return true 	iff constraints are propagated
+ * @return false 	iff they are not
+ */
+bool isConstraintPropagationEnabled();
+
+/**
+ * solveBoard is used to solve a given sudoku board in place, using the currently
+ * selected engine (see setSolverEngine).
+ *
+ * @param board				[in, out] a pointer to the Board struct to be solved. If solving
+ * 							succeeds, its empty cells are filled with a solution; otherwise the
+ * 							board is left unchanged
+ * @param budget 			[in] the budget of the search, or NULL for no limit
+ * @param statsOut 			[out] if not NULL, assigned with the counters of the search
+ * @return SolverStatus		SOLVER_SOLVED iff the board was successfully solved,
+ * 							SOLVER_UNSOLVABLE iff the board has no solution, and SOLVER_GAVE_UP
+ * 							iff the budget was exhausted first
+ */
+SolverStatus solveBoard(Board* board, const SearchBudget* budget, SolverStats* statsOut);
 
 /**
  * solvePuzzle is used to solve a given sudoku puzzle board by assigning valid
  * values to its cells, one at a time. The values are selected using the deterministic
- * backtracking algorithm.
+ * backtracking algorithm, with the currently selected engine (see setSolverEngine).
  *
- * @param state			[in] current state of the game
- * @param solutionOut 	[in, out] a pointer to a Board struct, to be assigned with a solution
- * 						for the given board
- * @return true 		iff the game in its current state was successfully solved
- * @return false 		iff solving the board has failed
+ * @param state				[in] current state of the game
+ * @param solutionOut 		[in, out] a pointer to a Board struct, to be assigned with a solution
+ * 							for the given board. It must have the block size of the game
+ * @param budget 			[in] the budget of the search, or NULL for no limit
+ * @param statsOut 			[out] if not NULL, assigned with the counters of the search
+ * @return SolverStatus		the result of solving the game in its current state (see solveBoard)
  */
-bool solvePuzzle(State* state, Board* solution);
+SolverStatus solvePuzzle(State* state, Board* solutionOut, const SearchBudget* budget, SolverStats* statsOut);
+
+/**
+ * solvePuzzleIncrementally solves a sudoku puzzle as solvePuzzle does, but starting from the
+ * game's stored solution rather than from scratch. Only the cells sharing a row, column or
+ * block with a filled cell which deviates from the stored solution are searched; all other
+ * empty cells keep their stored solution value. If no solution is found this way, the puzzle
+ * is solved from scratch, so the result is the same as solvePuzzle's.
+ *
+ * @param state				[in] current state of the game
+ * @param solutionOut 		[in, out] a pointer to a Board struct, to be assigned with a solution
+ * 							for the given board. It must have the block size of the game
+ * @param budget 			[in] the budget of both searches together, or NULL for no limit
+ * @param statsOut 			[out] if not NULL, assigned with the counters of the search,
+ * 							including those of the search from scratch if there was one
+ * @return SolverStatus		the result of solving the game in its current state (see solveBoard)
+ */
+SolverStatus solvePuzzleIncrementally(State* state, Board* solutionOut, const SearchBudget* budget, SolverStats* statsOut);
 
 /**
  * generatePuzzle is used to generate a sudoku puzzle board by assingning valid
  * values to its cells, one at a time. The values are selected using the randomized
- * backtracking algorithm.
+ * backtracking algorithm. When ITERATIVE_ENGINE is selected, the randomized search is
+ * run on an explicit search stack rather than by recursion. When constraint propagation is
+ * enabled (see setConstraintPropagation), a randomized propagating search is used instead.
+ *
+ * @param board				[in, out] a pointer to a board struct, of any block size
+ * @param generator 		[in, out] the random generator selecting the values; the same board
+ * 							is generated from generators in the same state
+ * @param budget 			[in] the budget of the search, or NULL for no limit
+ * @param statsOut 			[out] if not NULL, assigned with the counters of the search
+ * @return SolverStatus		SOLVER_SOLVED iff a board was generated successfully,
+ * 							SOLVER_UNSOLVABLE iff a board could not be generated, and
+ * 							SOLVER_GAVE_UP iff the budget was exhausted first
+ */
+SolverStatus generatePuzzle(Board* board, RandomGenerator* generator, const SearchBudget* budget, SolverStats* statsOut);
+
+/**
+ * countSolutions is used to count the number of distinct solutions of a given sudoku board.
+ * The search follows the minimum remaining values heuristic (using the kernel specialized for
+ * the board's size, see kernel.h) and stops as soon as limit solutions have been found, so
+ * checking a puzzle for uniqueness costs no more than finding two solutions.
+ *
+ * @param board		[in, out] a pointer to the Board struct whose solutions are counted. It is
+ * 					restored to its original contents before returning
+ * @param limit 	[in] the number of solutions at which counting stops
+ * @return int		the number of solutions of board, or limit if there are at least limit
+ */
+int countSolutions(Board* board, int limit);
+
+/**
+ * fixUniqueClues is used to turn a completely filled board into a puzzle with a unique
+ * solution. Starting with every cell as a clue, cells are visited in random order and each
+ * clue removal is only kept if the remaining clues still have exactly one solution. Removal
+ * stops once numCellsToFill clues remain. The remaining clues are then marked as fixed
+ * (see fixCell); the values of the board are not changed.
+ *
+ * @param board				[in, out] a pointer to a completely filled Board struct
+ * @param numCellsToFill 	[in] the desired number of clues
+ * @param generator 		[in, out] the random generator ordering the cells
+ * @return int				the number of cells fixed. This is more than numCellsToFill if no
+ * 							further clue could be removed without losing uniqueness
+ */
+int fixUniqueClues(Board* board, int numCellsToFill, RandomGenerator* generator);
+
+/**
+ * SolverContext struct holds the complete state of a resumable search: the board being
+ * filled, the worklist of its empty cells, and an explicit stack holding, for every cell
+ * filled by the search, the candidates not tried yet. Its implementation is hidden.
+ */
+typedef struct SolverContext SolverContext;
+
+/**
+ * createSolverContext starts a resumable search over a sudoku board. No search is performed
+ * until solverStep is called. If allocation fails, an error message is printed out and the
+ * process is terminated.
+ *
+ * @param board				[in] the board to be filled; it is copied, and not modified
+ * @param generator 		[in, out] if NULL, candidates are tried in ascending order (as in
+ * 							solveBoard); otherwise, they are tried in an order drawn from
+ * 							this generator (as in generatePuzzle), which must then outlive the
+ * 							search and not be used by other threads meanwhile
+ * @return SolverContext*	a pointer to the new search context
+ *
+ * @note	you must later call destroySolverContext with the pointer returned.
+ */
+SolverContext* createSolverContext(Board* board, RandomGenerator* generator);
+
+/**
+ * splitSolverContext splits a search that has not been stepped yet into independent searches,
+ * one for every candidate of the cell the search would branch on first. The children are
+ * returned in the order the search would have tried them, and each of them searches its
+ * subtree exactly as the parent would have (so the first solution of the first child having
+ * one is the solution the parent would have found). The parent is not modified.
+ * If allocation fails, an error message is printed out and the process is terminated.
+ *
+ * @param context			[in] the search context, which solverStep was not called on
+ * @param childrenOut 		[out] an array of at least dimension pointers, to be assigned with
+ * 							the new search contexts
+ * @return int				the number of children created; 0 if the board has no empty cell
+ * 							or has an empty cell with no candidate, in which case the parent
+ * 							can be stepped to find out which
+ *
+ * @note	you must later call destroySolverContext with every child returned.
+ */
+int splitSolverContext(SolverContext* context, SolverContext** childrenOut);
+
+/**
+ * solverStep resumes a search for at most maxNodes nodes, i.e. values placed in cells. The
+ * search always branches on the empty cell with the fewest candidates. Searches created by
+ * createSolverContext have no budget of their own (see SearchBudget): they are only bounded by
+ * the maxNodes of every step.
+ *
+ * @param context			[in, out] the search context
+ * @param maxNodes 			[in] the maximal number of nodes to visit in this call
+ * @return SolverStatus		the status of the search after this call
+ */
+SolverStatus solverStep(SolverContext* context, long maxNodes);
+
+/**
+ * exportSolverBoard exports the board of a search. Once solverStep has returned SOLVER_SOLVED,
+ * this is the solution found.
+ *
+ * @param context		[in] the search context
+ * @param boardOut 		[in, out] a pointer to a Board struct, to be assigned with the board
+ */
+void exportSolverBoard(SolverContext* context, Board* boardOut);
+
+/**
+ * addSolverContextStats adds the counters of a search, over all the steps run so far, to a
+ * running total.
+ *
+ * @param context		[in] the search context
+ * @param totalInOut 	[in, out] the running total
+ */
+void addSolverContextStats(SolverContext* context, SolverStats* totalInOut);
+
+/**
+ * destroySolverContext frees the resources of a search.
  *
- * @param board		[in, out] a pointer to a board struct
- * @return true 	iff a board was generated successfully
- * @return false 	iff a board could not be generated
+ * @param context 	[in] a search context previously acquired through createSolverContext
  */
-bool generatePuzzle(Board* board);
+void destroySolverContext(SolverContext* context);
 
 #endif /* SOLVER_H_ */
@@ -0,0 +1,51 @@
+#include "stats.h"
+
+void resetSolverStats(SolverStats* stats) {
+	stats->numNodes = 0;
+	stats->numBacktracks = 0;
+	stats->numValidityChecks = 0;
+	stats->maxDepth = 0;
+	stats->seconds = 0;
+	stats->hasGivenUp = false;
+	stats->maxNodes = 0;
+	stats->deadline = 0;
+}
+
+void startSearchBudget(SolverStats* stats, const SearchBudget* budget) {
+	resetSolverStats(stats);
+	if (budget != NULL) {
+		stats->maxNodes = budget->maxNodes;
+		if (budget->maxSeconds > 0) {
+			stats->deadline = getWallClockSeconds() + budget->maxSeconds;
+		}
+	}
+}
+
+bool recordSearchNode(SolverStats* stats, int depth) {
+	if (stats->hasGivenUp) {
+		return false;
+	}
+	if ((stats->maxNodes > 0 && stats->numNodes >= stats->maxNodes) ||
+		(stats->deadline > 0 && stats->numNodes % SEARCH_CLOCK_CHECK_INTERVAL == 0 &&
+		 getWallClockSeconds() >= stats->deadline)) {
+		stats->hasGivenUp = true;
+		return false;
+	}
+
+	stats->numNodes++;
+	if (depth > stats->maxDepth) {
+		stats->maxDepth = depth;
+	}
+	return true;
+}
+
+void addSolverStats(SolverStats* totalInOut, const SolverStats* stats) {
+	totalInOut->numNodes += stats->numNodes;
+	totalInOut->numBacktracks += stats->numBacktracks;
+	totalInOut->numValidityChecks += stats->numValidityChecks;
+	if (stats->maxDepth > totalInOut->maxDepth) {
+		totalInOut->maxDepth = stats->maxDepth;
+	}
+	totalInOut->seconds += stats->seconds;
+	totalInOut->hasGivenUp = totalInOut->hasGivenUp || stats->hasGivenUp;
+}
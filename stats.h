@@ -0,0 +1,107 @@
+/**
+ * STATS Summary:
+ *
+ * A module designed to count the work done by the solving and generating searches, so that
+ * their cost can be compared across engines and boards, and to stop searches which exceed a
+ * budget of work.
+ *
+ * resetSolverStats - sets all the counters of a SolverStats struct to zero
+ * startSearchBudget - resets the counters of a search, and sets the budget it may use
+ * recordSearchNode - counts a node visited by a search, unless its budget is exhausted
+ * addSolverStats - adds the counters of a SolverStats struct to those of another
+ */
+
+#ifndef STATS_H_
+#define STATS_H_
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "timing.h"
+
+/**
+ * The number of nodes a search visits between two readings of the clock, to check whether its
+ * deadline has passed.
+ */
+#define SEARCH_CLOCK_CHECK_INTERVAL (1024)
+
+/**
+ * SearchBudget struct limits the work of a search:
+ * maxNodes		- the number of nodes the search may visit, or 0 for no limit
+ * maxSeconds	- the wall clock time the search may run for, or 0 for no limit
+ */
+typedef struct {
+	long maxNodes;
+	double maxSeconds;
+} SearchBudget;
+
+/**
+ * SolverStats struct holds the counters of a search:
+ * numNodes				- the number of nodes visited, i.e. values a search placed in a cell as a
+ * 						  guess. Values which follow from the board with no choice involved (e.g.
+ * 						  those filled by constraint propagation) are not counted
+ * numBacktracks		- the number of times the search gave up a cell (or, for DLX_ENGINE, a
+ * 						  constraint) because none of its values led to a solution, including
+ * 						  cells which had no valid value to begin with
+ * numValidityChecks	- the number of times the search checked which values a cell may hold:
+ * 						  either a single value (e.g. isCellValueValid) or all of them at once
+ * 						  (e.g. getCellCandidates). For DLX_ENGINE, the number of constraints
+ * 						  examined while choosing the constraint to branch on
+ * maxDepth				- the largest number of nested guesses the search had made at once
+ * seconds				- the wall clock duration of the search
+ * hasGivenUp			- whether the search was stopped because its budget was exhausted
+ * The budget of the search (see startSearchBudget) is kept alongside the counters:
+ * maxNodes				- the number of nodes the search may visit, or 0 for no limit
+ * deadline				- the wall clock time (see getWallClockSeconds) at which the search is
+ * 						  stopped, or 0 for no limit
+ */
+typedef struct {
+	long numNodes;
+	long numBacktracks;
+	long numValidityChecks;
+	int maxDepth;
+	double seconds;
+	bool hasGivenUp;
+	long maxNodes;
+	double deadline;
+} SolverStats;
+
+/**
+ * resetSolverStats sets all the counters of a SolverStats struct to zero.
+ *
+ * @param stats		[out] the counters to be reset
+ */
+void resetSolverStats(SolverStats* stats);
+
+/**
+ * startSearchBudget resets the counters of a search, and sets the budget it may use from now
+ * on.
+ *
+ * @param stats		[out] the counters of the search
+ * @param budget 	[in] the budget of the search, or NULL for no limit
+ */
+void startSearchBudget(SolverStats* stats, const SearchBudget* budget);
+
+/**
+ * recordSearchNode is called by a search before it visits a node, at a given depth. If the
+ * budget of the search allows it, the node is counted; otherwise hasGivenUp is set, and the
+ * search must unwind without visiting any further node.
+ *
+ * @param stats		[in, out] the counters of the search
+ * @param depth 	[in] the number of nested guesses made, including the one of this node
+ * @return true 	iff the node may be visited
+ * @return false 	iff the budget of the search is exhausted
+ */
+bool recordSearchNode(SolverStats* stats, int depth);
+
+/**
+ * addSolverStats adds the counters of a search to a running total. The maximal depth of the
+ * total becomes the larger of the two, and the total has given up if either has. The budget of
+ * the total is not changed.
+ *
+ * @param totalInOut	[in, out] the running total
+ * @param stats 		[in] the counters to be added
+ */
+void addSolverStats(SolverStats* totalInOut, const SolverStats* stats);
+
+#endif /* STATS_H_ */
@@ -0,0 +1,14 @@
+#include "timing.h"
+
+#define NANOSECONDS_PER_SECOND (1e9)
+
+double getWallClockSeconds() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / NANOSECONDS_PER_SECOND;
+}
+
+int getNumProcessors() {
+	long numProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+	return (numProcessors > 0) ? (int)numProcessors : 1;
+}
@@ -0,0 +1,31 @@
+/**
+ * TIMING Summary:
+ *
+ * A module designed to measure wall clock durations, for throughput and latency reports.
+ *
+ * getWallClockSeconds - returns the current time of a monotonic clock
+ * getNumProcessors - returns the number of processors available
+ */
+
+#ifndef TIMING_H_
+#define TIMING_H_
+
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * getWallClockSeconds returns the current time of a monotonic wall clock. Only differences
+ * between two returned values are meaningful.
+ *
+ * @return double	the current time, in seconds
+ */
+double getWallClockSeconds();
+
+/**
+ * getNumProcessors returns the number of processors currently online.
+ *
+ * @return int		the number of processors, and at least 1
+ */
+int getNumProcessors();
+
+#endif /* TIMING_H_ */
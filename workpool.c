@@ -0,0 +1,200 @@
+#include "workpool.h"
+
+/**
+ * WorkPool struct holds the shared state of a pool. Items with sequence numbers in
+ * [nextConsume, nextProduce) occupy the ring, at slot (sequenceNumber % capacity); those in
+ * [nextClaim, nextProduce) are waiting for a worker. isDone marks the slots whose item has
+ * been processed but not consumed yet. All fields are protected by mutex.
+ */
+typedef struct {
+	pthread_mutex_t mutex;
+	pthread_cond_t workAvailable;
+	pthread_cond_t headDone;
+	WorkItem* items;
+	bool* isDone;
+	int capacity;
+	long nextProduce;
+	long nextClaim;
+	long nextConsume;
+	bool isInputOver;
+	int blockSize;
+	WorkHandler handler;
+	void* context;
+} WorkPool;
+
+void exitOnFailure(bool isFailed, const char* functionName) {
+	if (isFailed) {
+		/* NOTE: for now we are allowed this behaviour: */
+		printf("Error: %s has failed\n", functionName);
+		exit(EXIT_FAILURE);
+	}
+}
+
+/**
+ * runWorker is the main function of the worker threads. It claims waiting items in sequence
+ * order, processes them, and wakes the consumer when the oldest item in the ring is done.
+ *
+ * @param argument	[in] a pointer to the WorkPool
+ * @return void*	NULL
+ */
+void* runWorker(void* argument) {
+	WorkPool* pool = (WorkPool*)argument;
+	Board* scratch = createBoard(pool->blockSize);
+
+	pthread_mutex_lock(&(pool->mutex));
+	while (true) {
+		long sequenceNumber = 0;
+		int slot = 0;
+
+		while (pool->nextClaim == pool->nextProduce && !pool->isInputOver) {
+			pthread_cond_wait(&(pool->workAvailable), &(pool->mutex));
+		}
+		if (pool->nextClaim == pool->nextProduce) {
+			break;
+		}
+
+		sequenceNumber = pool->nextClaim++;
+		slot = sequenceNumber % pool->capacity;
+		pthread_mutex_unlock(&(pool->mutex));
+
+		pool->handler(pool->context, &(pool->items[slot]), scratch);
+
+		pthread_mutex_lock(&(pool->mutex));
+		pool->isDone[slot] = true;
+		if (sequenceNumber == pool->nextConsume) {
+			pthread_cond_signal(&(pool->headDone));
+		}
+	}
+	pthread_mutex_unlock(&(pool->mutex));
+
+	destroyBoard(scratch);
+	return NULL;
+}
+
+/**
+ * runSerially processes a stream on the calling thread, one item at a time.
+ *
+ * @param blockSize 	[in] the block size of the boards
+ * @param producer 		[in] fills items
+ * @param handler 		[in] processes items
+ * @param consumer 		[in] receives processed items
+ * @param context 		[in, out] passed to all the callbacks
+ */
+void runSerially(int blockSize, WorkProducer producer, WorkHandler handler, WorkConsumer consumer, void* context) {
+	WorkItem item;
+	Board* scratch = createBoard(blockSize);
+
+	item.board = createBoard(blockSize);
+	item.status = 0;
+	item.sequenceNumber = 0;
+
+	while (producer(context, &item)) {
+		handler(context, &item, scratch);
+		consumer(context, &item);
+		item.sequenceNumber++;
+	}
+
+	destroyBoard(item.board);
+	destroyBoard(scratch);
+}
+
+/**
+ * runPoolProducerConsumer is run on the calling thread while the workers are running. It
+ * alternates between consuming the items at the head of the ring that are done, and producing
+ * new items while the ring has free slots, until the stream has ended and been consumed.
+ *
+ * @param pool 			[in, out] the pool
+ * @param producer 		[in] fills items
+ * @param consumer 		[in] receives processed items
+ */
+void runPoolProducerConsumer(WorkPool* pool, WorkProducer producer, WorkConsumer consumer) {
+	pthread_mutex_lock(&(pool->mutex));
+	while (true) {
+		while (pool->nextConsume < pool->nextProduce && pool->isDone[pool->nextConsume % pool->capacity]) {
+			int slot = pool->nextConsume % pool->capacity;
+			pthread_mutex_unlock(&(pool->mutex));
+			consumer(pool->context, &(pool->items[slot]));
+			pthread_mutex_lock(&(pool->mutex));
+			pool->isDone[slot] = false;
+			pool->nextConsume++;
+		}
+
+		if (!pool->isInputOver && pool->nextProduce - pool->nextConsume < pool->capacity) {
+			/* the slot is free, and no worker looks at it before nextProduce moves past it */
+			WorkItem* item = &(pool->items[pool->nextProduce % pool->capacity]);
+			bool isProduced = false;
+
+			pthread_mutex_unlock(&(pool->mutex));
+			item->sequenceNumber = pool->nextProduce;
+			isProduced = producer(pool->context, item);
+			pthread_mutex_lock(&(pool->mutex));
+
+			if (isProduced) {
+				pool->nextProduce++;
+				pthread_cond_signal(&(pool->workAvailable));
+			} else {
+				pool->isInputOver = true;
+				pthread_cond_broadcast(&(pool->workAvailable));
+			}
+		} else if (pool->isInputOver && pool->nextConsume == pool->nextProduce) {
+			break;
+		} else {
+			pthread_cond_wait(&(pool->headDone), &(pool->mutex));
+		}
+	}
+	pthread_mutex_unlock(&(pool->mutex));
+}
+
+void runWorkPool(int numThreads, int blockSize, WorkProducer producer, WorkHandler handler,
+				 WorkConsumer consumer, void* context) {
+	WorkPool pool;
+	pthread_t* threads = NULL;
+	int i = 0;
+
+	if (numThreads <= 1) {
+		runSerially(blockSize, producer, handler, consumer, context);
+		return;
+	}
+
+	pool.capacity = numThreads * WORK_POOL_SLOTS_PER_THREAD;
+	pool.items = calloc(pool.capacity, sizeof(WorkItem));
+	pool.isDone = calloc(pool.capacity, sizeof(bool));
+	threads = calloc(numThreads, sizeof(pthread_t));
+	exitOnFailure(pool.items == NULL || pool.isDone == NULL || threads == NULL, "runWorkPool");
+
+	for (i = 0; i < pool.capacity; i++) {
+		pool.items[i].board = createBoard(blockSize);
+	}
+	pool.nextProduce = 0;
+	pool.nextClaim = 0;
+	pool.nextConsume = 0;
+	pool.isInputOver = false;
+	pool.blockSize = blockSize;
+	pool.handler = handler;
+	pool.context = context;
+
+	exitOnFailure(pthread_mutex_init(&(pool.mutex), NULL) != 0, "runWorkPool");
+	exitOnFailure(pthread_cond_init(&(pool.workAvailable), NULL) != 0, "runWorkPool");
+	exitOnFailure(pthread_cond_init(&(pool.headDone), NULL) != 0, "runWorkPool");
+
+	for (i = 0; i < numThreads; i++) {
+		exitOnFailure(pthread_create(&(threads[i]), NULL, runWorker, &pool) != 0, "runWorkPool");
+	}
+
+	runPoolProducerConsumer(&pool, producer, consumer);
+
+	for (i = 0; i < numThreads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	pthread_cond_destroy(&(pool.headDone));
+	pthread_cond_destroy(&(pool.workAvailable));
+	pthread_mutex_destroy(&(pool.mutex));
+
+	for (i = 0; i < pool.capacity; i++) {
+		destroyBoard(pool.items[i].board);
+	}
+	free(pool.items);
+	free(pool.isDone);
+	free(threads);
+}
@@ -0,0 +1,94 @@
+/**
+ * WORKPOOL Summary:
+ *
+ * A module designed to process a stream of boards on a pool of worker threads, while keeping
+ * the input order on output. Items are read by a producer into a ring of slots, handled by the
+ * workers in any order, and handed to a consumer strictly in the order they were produced.
+ * The ring doubles as a bounded reorder buffer: the producer waits for the oldest item to be
+ * consumed before reusing its slot, so memory use does not depend on the length of the stream.
+ *
+ * exitOnFailure - terminates the process if a resource of a thread could not be acquired
+ * runWorkPool - runs a producer, a pool of workers and an ordered consumer over a stream
+ */
+
+#ifndef WORKPOOL_H_
+#define WORKPOOL_H_
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "game.h"
+
+/**
+ * The number of ring slots per worker thread.
+ */
+#define WORK_POOL_SLOTS_PER_THREAD (64)
+
+/**
+ * WorkItem struct represents one item of the stream: a board, owned by its ring slot, and a
+ * status, whose meaning is up to the callbacks.
+ */
+typedef struct {
+	Board* board;
+	int status;
+	long sequenceNumber;
+} WorkItem;
+
+/**
+ * WorkProducer is called on the calling thread to fill the next item of the stream.
+ *
+ * @param context	[in, out] the context provided to runWorkPool
+ * @param item 		[in, out] the item to be filled; its board must be overwritten
+ * @return true 	iff an item was produced
+ * @return false 	iff the stream has ended
+ */
+typedef bool (*WorkProducer)(void* context, WorkItem* item);
+
+/**
+ * WorkHandler is called on a worker thread to process an item.
+ *
+ * @param context	[in, out] the context provided to runWorkPool; shared by all workers
+ * @param item 		[in, out] the item to be processed
+ * @param scratch 	[in, out] a board owned by the calling worker, of the block size of the
+ * 					pool, which may be used freely
+ */
+typedef void (*WorkHandler)(void* context, WorkItem* item, Board* scratch);
+
+/**
+ * WorkConsumer is called on the calling thread with every processed item, in the order the
+ * items were produced.
+ *
+ * @param context	[in, out] the context provided to runWorkPool
+ * @param item 		[in] the processed item
+ */
+typedef void (*WorkConsumer)(void* context, WorkItem* item);
+
+/**
+ * exitOnFailure terminates the process if a resource of a thread (memory, a thread, a mutex or
+ * a condition variable) could not be acquired. It is shared by the threaded modules.
+ *
+ * @param isFailed		[in] whether the acquisition has failed
+ * @param functionName 	[in] the name of the function which has failed, for the error message
+ */
+void exitOnFailure(bool isFailed, const char* functionName);
+
+/**
+ * runWorkPool runs a stream of items through a producer, a pool of workers and a consumer,
+ * returning once every item produced has been consumed. With a single thread, everything runs
+ * on the calling thread, one item at a time.
+ * If resources could not be allocated, an error message is printed out and the process is
+ * terminated.
+ *
+ * @param numThreads 	[in] the number of worker threads
+ * @param blockSize 	[in] the block size of the boards of the items and the scratch boards
+ * @param producer 		[in] fills items, on the calling thread
+ * @param handler 		[in] processes items, on the worker threads
+ * @param consumer 		[in] receives processed items in order, on the calling thread
+ * @param context 		[in, out] passed to all the callbacks
+ */
+void runWorkPool(int numThreads, int blockSize, WorkProducer producer, WorkHandler handler,
+				 WorkConsumer consumer, void* context);
+
+#endif /* WORKPOOL_H_ */